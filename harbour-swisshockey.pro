@@ -6,7 +6,13 @@ TARGET = harbour-swisshockey
 #CONFIG += sailfishapp_no_deploy_qml
 CONFIG += sailfishapp
 QT += core network dbus
-PKGCONFIG += mlite5 nemonotifications-qt5
+PKGCONFIG += mlite5 nemonotifications-qt5 zlib
+
+# Brotli is optional; gzip/deflate is always available
+packagesExist(libbrotlidec) {
+    PKGCONFIG += libbrotlidec
+    DEFINES += HAVE_BROTLI
+}
 
 
 # QML files & icons
@@ -37,7 +43,18 @@ SOURCES += \
     src/jsondecoder.cpp \
     src/league.cpp \
     src/player.cpp \
-    src/notifier.cpp
+    src/notifier.cpp \
+    src/validatorcache.cpp \
+    src/replydecoder.cpp \
+    src/requestmanager.cpp \
+    src/updatescheduler.cpp \
+    src/jsonstreamparser.cpp \
+    src/jsonscanner.cpp \
+    src/summariesdecoder.cpp \
+    src/detailsdecoder.cpp \
+    src/parsepipeline.cpp \
+    src/gamescore.cpp \
+    src/parsearena.cpp
 
 # Add QML files to Qt Creator
 OTHER_FILES += qml/harbour-swisshockey.qml \
@@ -84,7 +101,19 @@ HEADERS += \
     src/jsondecoder.h \
     src/league.h \
     src/player.h \
-    src/notifier.h
+    src/notifier.h \
+    src/validatorcache.h \
+    src/replydecoder.h \
+    src/requestmanager.h \
+    src/updatescheduler.h \
+    src/jsonstreamparser.h \
+    src/jsonscanner.h \
+    src/summariesdecoder.h \
+    src/detailsdecoder.h \
+    src/parsepipeline.h \
+    src/spscqueue.h \
+    src/gamescore.h \
+    src/parsearena.h
 
 DISTFILES += \
     qml/pages/EventsPage.qml \
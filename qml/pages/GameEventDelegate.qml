@@ -39,7 +39,7 @@ ListItem {
             pixelSize: Theme.fontSizeMedium
         }
         color: Theme.highlightColor
-        text: model.event.time
+        text: model.time
     }
 
     // Label containing the player
@@ -54,7 +54,7 @@ ListItem {
             pixelSize: Theme.fontSizeMedium
         }
         color: Theme.highlightColor
-        text: model.event.player
+        text: model.player
     }
 
     // Label containing the assist or penalty type
@@ -68,7 +68,7 @@ ListItem {
             pixelSize: Theme.fontSizeMedium
         }
         color: Theme.secondaryColor
-        text: model.event.info
+        text: model.info
     }
 
     // Label containing the score or the penalty
@@ -86,7 +86,7 @@ ListItem {
             pixelSize: Theme.fontSizeMedium
         }
         color: Theme.highlightColor
-        text: model.event.value
+        text: model.value
     }
 
     // Additional text under the score/penalty
@@ -103,6 +103,6 @@ ListItem {
             pixelSize: Theme.fontSizeMedium
         }
         color: Theme.secondaryColor
-        text: model.event.context
+        text: model.context
     }
 }
@@ -39,6 +39,7 @@ class DataSource : public QObject {
         virtual void update(QString id) = 0;
 
     signals:
+        // An empty message signals that the error condition has cleared
         void updateError(QString message);
         void updateStarted();
         void updateFinished();
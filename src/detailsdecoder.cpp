@@ -0,0 +1,233 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "detailsdecoder.h"
+#include "event.h"
+
+// The goal texts are formatted as '**EQ,GWG** / **0:1** - <Player Names>', the
+// goalkeeper texts as '<Player Name> (ACTION)', where ACTION is IN or OUT
+DetailsDecoder::DetailsDecoder(QObject *parent) : JsonDecoder(parent),
+    mScoreTypeNeedle("(\\w+)"), mScoreNeedle("(\\d+:\\d+)"), mGoalkeeperInNeedle("\\(IN\\)") {
+    clear();
+}
+
+void DetailsDecoder::clear(void) {
+    mRecord = DetailsRecord();
+    mRecord.hasPlayers = false;
+    mRecord.hasSummary = false;
+    mArena.release();
+}
+
+const DetailsRecord &DetailsDecoder::getRecord(void) const {
+    return mRecord;
+}
+
+const ParseArena &DetailsDecoder::getArena(void) const {
+    return mArena;
+}
+
+void DetailsDecoder::beginContainer(bool isObject) {
+    if(getDepth() == 0) {
+        return;
+    } else if(getDepth() == 1) {
+        if(getKey(0) == "players") {
+            mRecord.hasPlayers = true;
+        } else if(getKey(0) == "summary") {
+            mRecord.hasSummary = true;
+        }
+    } else if(isObject) {
+        beginEvent();
+    }
+}
+
+// Adds a new record for objects in one of the lists (players, period events,
+// shootout)
+void DetailsDecoder::beginEvent(void) {
+    // The records are value-initialized by the arena, i.e. all the IDs are 0
+    if(getDepth() == 2 && getKey(0) == "players") {
+        mRecord.players.append(mArena.create<PlayerRecord>());
+    } else if(getKey(0) != "summary") {
+        return;
+    } else if(getDepth() == 3 && getKey(1) == "periods") {
+        mRecord.periods.append(mArena.create<PeriodRecord>());
+    } else if(getDepth() == 5 && getKey(1) == "periods" && !mRecord.periods.isEmpty()) {
+        PeriodRecord *period = mRecord.periods.last();
+        const QString &list = getKey(3);
+        if(list == "goals") {
+            period->goals.append(mArena.create<GoalRecord>());
+        } else if(list == "fouls") {
+            period->penalties.append(mArena.create<PenaltyRecord>());
+        } else if(list == "goalkeepers") {
+            period->goalkeepers.append(mArena.create<GoalkeeperRecord>());
+        }
+    } else if(getDepth() == 4 && getKey(1) == "shootout" && getKey(2) == "shoots") {
+        mRecord.shootout.append(mArena.create<ShotRecord>());
+    }
+}
+
+void DetailsDecoder::value(const QVariant &value) {
+    if(getDepth() == 1) {
+        const QString &key = getKey(0);
+        if(key == "gameId") {
+            mRecord.gameId = value.toString();
+        } else if(key == "players") {
+            mRecord.hasPlayers = true;
+        } else if(key == "summary") {
+            mRecord.hasSummary = true;
+        }
+    } else if(getDepth() == 3 && getKey(0) == "players" && !mRecord.players.isEmpty()) {
+        PlayerRecord *player = mRecord.players.last();
+        const QString &field = getKey(2);
+        if(field == "teamId") {
+            player->teamId = value.toULongLong();
+        } else if(field == "id") {
+            player->playerId = value.toUInt();
+        } else if(field == "fullName") {
+            player->fullName = value.toString();
+        } else if(field == "jerseyNumber") {
+            player->jerseyNumber = value.toUInt();
+        }
+    } else if(getKey(0) == "lineUps") {
+        lineupValue(value);
+    } else if(getKey(0) == "summary") {
+        if(getDepth() == 6 && getKey(1) == "periods") {
+            periodValue(value);
+        } else if(getDepth() == 5 && getKey(1) == "shootout" && getKey(2) == "shoots") {
+            shotValue(value);
+        }
+    }
+}
+
+// The lineups are nested by team, position and side:
+// lineUps.<team>.goalkeepers[line] and lineUps.<team>.<defenders|forwarders>.<side>[line]
+void DetailsDecoder::lineupValue(const QVariant &value) {
+    LineupRecord *lineup;
+    if(getDepth() < 4) {
+        return;
+    } else if(getKey(1) == "homeTeam") {
+        lineup = &mRecord.hometeamLineup;
+    } else if(getKey(1) == "awayTeam") {
+        lineup = &mRecord.awayteamLineup;
+    } else {
+        return;
+    }
+
+    int position = Player::POSITION_UNDEFINED;
+    const QString &group = getKey(2);
+    if(getDepth() == 4 && group == "goalkeepers") {
+        position = Player::POSITION_GK;
+    } else if(getDepth() == 5) {
+        const QString &side = getKey(3);
+        if(group == "defenders") {
+            if(side == "left") {
+                position = Player::POSITION_LD;
+            } else if(side == "right") {
+                position = Player::POSITION_RD;
+            }
+        } else if(group == "forwarders") {
+            if(side == "left") {
+                position = Player::POSITION_LW;
+            } else if(side == "center") {
+                position = Player::POSITION_C;
+            } else if(side == "right") {
+                position = Player::POSITION_RW;
+            }
+        }
+    }
+
+    if(position != Player::POSITION_UNDEFINED) {
+        lineup->positions[position].append(value.toUInt());
+    }
+}
+
+// Fields of the goals, fouls and goalkeepers of a period:
+// summary.periods[period].<list>[event].<field>
+void DetailsDecoder::periodValue(const QVariant &value) {
+    if(mRecord.periods.isEmpty()) {
+        return;
+    }
+
+    PeriodRecord *period = mRecord.periods.last();
+    const QString &list = getKey(3);
+    const QString &field = getKey(5);
+    if(list == "goals" && !period->goals.isEmpty()) {
+        GoalRecord *goal = period->goals.last();
+        if(field == "teamId") {
+            goal->teamId = value.toLongLong();
+        } else if(field == "scorerLicenceNr") {
+            goal->scorerId = value.toUInt();
+        } else if(field == "assist1LicenceNr") {
+            goal->assist1Id = value.toUInt();
+        } else if(field == "assist2LicenceNr") {
+            goal->assist2Id = value.toUInt();
+        } else if(field == "time") {
+            goal->time = Event::parseTime(value.toString());
+        } else if(field == "text") {
+            goal->text = value.toString();
+            mScoreTypeNeedle.indexIn(goal->text);
+            goal->scoreType = mScoreTypeNeedle.cap(1);
+            mScoreNeedle.indexIn(goal->text);
+            goal->score = mScoreNeedle.cap(1);
+        }
+    } else if(list == "fouls" && !period->penalties.isEmpty()) {
+        PenaltyRecord *penalty = period->penalties.last();
+        if(field == "teamId") {
+            penalty->teamId = value.toLongLong();
+        } else if(field == "playerLicenceNr") {
+            penalty->playerId = value.toUInt();
+        } else if(field == "time") {
+            penalty->time = Event::parseTime(value.toString());
+        } else if(field == "id") {
+            penalty->penaltyId = value.toInt();
+        } else if(field == "minutes") {
+            penalty->minutes = value.toString();
+        }
+    } else if(list == "goalkeepers" && !period->goalkeepers.isEmpty()) {
+        GoalkeeperRecord *goalkeeper = period->goalkeepers.last();
+        if(field == "teamId") {
+            goalkeeper->teamId = value.toLongLong();
+        } else if(field == "playerLicenceNr") {
+            goalkeeper->playerId = value.toUInt();
+        } else if(field == "time") {
+            goalkeeper->time = Event::parseTime(value.toString());
+        } else if(field == "text") {
+            goalkeeper->entering = (mGoalkeeperInNeedle.indexIn(value.toString()) != -1);
+        }
+    }
+}
+
+// Fields of the shots of the shootout: summary.shootout.shoots[shot].<field>
+void DetailsDecoder::shotValue(const QVariant &value) {
+    if(mRecord.shootout.isEmpty()) {
+        return;
+    }
+
+    ShotRecord *shot = mRecord.shootout.last();
+    const QString &field = getKey(4);
+    if(field == "scorerLicenceNr") {
+        shot->scorerId = value.toUInt();
+    } else if(field == "goalkeeperLiceneNr") {
+        // Sic, that's what the field is called
+        shot->goalkeeperId = value.toUInt();
+    } else if(field == "number") {
+        shot->number = (quint16) value.toUInt();
+    } else if(field == "scored") {
+        shot->scored = value.toBool();
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef DETAILSDECODER_H
+#define DETAILSDECODER_H
+
+#include <QRegExp>
+#include <QString>
+#include <QVector>
+
+#include "jsondecoder.h"
+#include "parsearena.h"
+#include "player.h"
+
+// The player IDs per position (indexed by Player::PLAYER_POSITION) in order
+// of the lines
+struct LineupRecord {
+    QVector<quint32> positions[Player::POSITION_C + 1];
+};
+
+struct PlayerRecord {
+    qulonglong teamId;
+    quint32 playerId;
+    QString fullName;
+    quint8 jerseyNumber;
+};
+
+struct GoalRecord {
+    qulonglong teamId;
+    quint32 scorerId;
+    quint32 assist1Id;
+    quint32 assist2Id;
+    quint32 time;
+    QString text;
+    QString score;
+    QString scoreType;
+};
+
+struct PenaltyRecord {
+    qulonglong teamId;
+    quint32 playerId;
+    quint32 time;
+    int penaltyId;
+    QString minutes;
+};
+
+struct GoalkeeperRecord {
+    qulonglong teamId;
+    quint32 playerId;
+    quint32 time;
+    bool entering;
+};
+
+struct PeriodRecord {
+    QVector<GoalRecord *> goals;
+    QVector<PenaltyRecord *> penalties;
+    QVector<GoalkeeperRecord *> goalkeepers;
+};
+
+struct ShotRecord {
+    quint32 scorerId;
+    quint32 goalkeeperId;
+    quint16 number;
+    bool scored;
+};
+
+// The game details. The records in the lists are owned by the decoder and
+// live as long as it does (or until it's reset).
+struct DetailsRecord {
+    QString gameId;
+    bool hasPlayers;
+    bool hasSummary;
+    LineupRecord hometeamLineup;
+    LineupRecord awayteamLineup;
+    QVector<PlayerRecord *> players;
+    QVector<PeriodRecord *> periods;
+    QVector<ShotRecord *> shootout;
+};
+
+// Decodes the gameoverview response straight into a DetailsRecord. All the
+// records of a response are allocated from one arena and released together.
+// The event times (in tenths of a second) and the texts the API only provides
+// in human-readable form (the score and play of a goal, goalkeeper changes)
+// are parsed here as well, so that this happens on the parser thread.
+class DetailsDecoder : public JsonDecoder {
+    Q_OBJECT
+
+    private:
+        ParseArena mArena;
+        DetailsRecord mRecord;
+
+        // Patterns for the human-readable texts
+        QRegExp mScoreTypeNeedle;
+        QRegExp mScoreNeedle;
+        QRegExp mGoalkeeperInNeedle;
+
+        void beginEvent(void);
+        void lineupValue(const QVariant &value);
+        void periodValue(const QVariant &value);
+        void shotValue(const QVariant &value);
+
+    protected:
+        void beginContainer(bool isObject);
+        void value(const QVariant &value);
+        void clear(void);
+
+    public:
+        explicit DetailsDecoder(QObject *parent = 0);
+
+        const DetailsRecord &getRecord(void) const;
+        const ParseArena &getArena(void) const;
+};
+
+#endif // DETAILSDECODER_H
@@ -17,48 +17,108 @@
  * swisshockey. If not, see http://www.gnu.org/licenses/.
  */
 
+#include <QStringList>
+
 #include "event.h"
 #include "logger.h"
 
+const quint32 Event::TENTHS_PER_SECOND;
+const quint32 Event::TENTHS_PER_MINUTE;
+
 Event::Event(int type) {
     this->mType = type;
+    this->mTime = 0;
+    this->mSequence = 0;
+    this->mPeriod = 0;
+    this->mTeam = 0;
+    this->mPenaltyId = 0;
+    this->mPenaltyShot = false;
+    for(int role = 0; role < ROLE_LENGTH; role++) {
+        this->mPlayers[role] = nullptr;
+    }
 }
 
-int Event::getType(void) {
+int Event::getType(void) const {
     return this->mType;
 }
 
-void Event::setTime(QString time) {
-    QStringList split = time.split(":");
-    if(split.size() == 2) {
-        this->mTime = 60*split[0].toFloat() + split[1].toFloat();
-    } else {
-        this->mTime = 0;
+// Parses a game time formatted as 'mm:ss' or 'mm:ss.t' into tenths of a
+// second, returns 0 if the time is malformed
+quint32 Event::parseTime(const QString &time) {
+    int colon = time.indexOf(':');
+    if(colon < 0) {
+        return 0;
+    }
+
+    bool ok = false;
+    quint32 minutes = time.left(colon).toUInt(&ok);
+    if(!ok) {
+        return 0;
     }
+
+    QString rest = time.mid(colon + 1);
+    quint32 tenths = 0;
+    int dot = rest.indexOf('.');
+    if(dot >= 0) {
+        tenths = rest.mid(dot + 1, 1).toUInt(&ok);
+        if(!ok) {
+            return 0;
+        }
+        rest.truncate(dot);
+    }
+    quint32 seconds = rest.toUInt(&ok);
+    if(!ok) {
+        return 0;
+    }
+
+    return minutes*TENTHS_PER_MINUTE + seconds*TENTHS_PER_SECOND + tenths;
 }
 
-float Event::getTime(void) const {
+void Event::setTime(QString time, quint16 sequence) {
+    setTime(Event::parseTime(time), sequence);
+}
+
+void Event::setTime(quint32 tenths, quint16 sequence) {
+    this->mTime = tenths;
+    this->mSequence = sequence;
+}
+
+quint32 Event::getTime(void) const {
     return mTime;
 }
 
+quint16 Event::getSequence(void) const {
+    return mSequence;
+}
+
 QString Event::getTimeString(void) const {
-    quint32 minutes = (int) mTime/60;
-    quint32 seconds = (int)(mTime-minutes*60);
+    quint32 minutes = mTime/TENTHS_PER_MINUTE;
+    quint32 seconds = (mTime%TENTHS_PER_MINUTE)/TENTHS_PER_SECOND;
     QString time;
     time.sprintf("%02u:%02u", minutes, seconds);
     return time;
 }
 
+void Event::setPeriod(quint8 period) {
+    this->mPeriod = period;
+}
+
+quint8 Event::getPeriod(void) const {
+    return mPeriod;
+}
+
 void Event::setTeam(qlonglong team) {
     this->mTeam = team;
 }
 
-qlonglong Event::getTeam(void) {
+qlonglong Event::getTeam(void) const {
     return this->mTeam;
 }
 
 void Event::addPlayer(int role, Player *player){
-    this->mPlayers[role] = player;
+    if(role >= 0 && role < ROLE_LENGTH) {
+        this->mPlayers[role] = player;
+    }
 }
 
 void Event::setScore(QString score, QString type) {
@@ -75,7 +135,7 @@ void Event::setPenalty(int id, QString type) {
     }
 }
 
-int Event::getPenalty(void) {
+int Event::getPenalty(void) const {
     return this->mPenaltyId;
 }
 
@@ -110,11 +170,11 @@ Player *Event::getPlayer(void) const {
             role = -1;
             break;
     }
-    return mPlayers.value(role, nullptr);
+    return getPlayer(role);
 }
 
 Player *Event::getPlayer(int role) const {
-    return this->mPlayers[role];
+    return (role >= 0 && role < ROLE_LENGTH) ? this->mPlayers[role] : nullptr;
 }
 
 QString Event::getPlayerString(void) const {
@@ -155,11 +215,11 @@ QString Event::getInfo(void) const {
 
     switch(type) {
         case Event::GOAL: {
-                Player *player = mPlayers.value(Event::FIRST_ASSIST, nullptr);
+                Player *player = getPlayer(Event::FIRST_ASSIST);
                 if(player != nullptr) {
                     text.append(player->getName());
                 }
-                player = mPlayers.value(Event::SECOND_ASSIST, nullptr);
+                player = getPlayer(Event::SECOND_ASSIST);
                 if(player != nullptr) {
                     text.append(", " + player->getName());
                 }
@@ -198,17 +258,64 @@ QString Event::getContext(void) const {
     return info;
 }
 
+// Two events are equal if they have the same key and show the same content
+bool Event::operator==(const Event &other) const {
+    if(compareKey(*this, other) != 0) {
+        return false;
+    }
+    for(int role = 0; role < ROLE_LENGTH; role++) {
+        if(mPlayers[role] != other.mPlayers[role]) {
+            return false;
+        }
+    }
+    return mScore == other.mScore && mScoreType == other.mScoreType
+        && mPenaltyId == other.mPenaltyId && mPenaltyType == other.mPenaltyType
+        && mPenaltyShot == other.mPenaltyShot;
+}
+
+bool Event::operator!=(const Event &other) const {
+    return !(*this == other);
+}
+
+// Compares the keys of two events, that is, their period, time, sequence
+// number, type, team, and the main player involved. Returns a negative value
+// if e1 comes before e2, zero if the keys are the same, and a positive value
+// otherwise.
+int Event::compareKey(const Event &e1, const Event &e2) {
+    if(e1.mPeriod != e2.mPeriod) {
+        return (e1.mPeriod < e2.mPeriod) ? -1 : 1;
+    }
+    if(e1.mTime != e2.mTime) {
+        return (e1.mTime < e2.mTime) ? -1 : 1;
+    }
+    if(e1.mSequence != e2.mSequence) {
+        return (e1.mSequence < e2.mSequence) ? -1 : 1;
+    }
+    if(e1.mType != e2.mType) {
+        return (e1.mType < e2.mType) ? -1 : 1;
+    }
+    if(e1.mTeam != e2.mTeam) {
+        return (e1.mTeam < e2.mTeam) ? -1 : 1;
+    }
+
+    Player *p1 = e1.getPlayer();
+    Player *p2 = e2.getPlayer();
+    quint32 id1 = (p1 != nullptr) ? p1->getPlayerId() : 0;
+    quint32 id2 = (p2 != nullptr) ? p2->getPlayerId() : 0;
+    if(id1 != id2) {
+        return (id1 < id2) ? -1 : 1;
+    }
+    return 0;
+}
+
 // Compares if e1 > e2
-bool Event::greaterThan(const Event *e1, const Event *e2) {
-    float t1 = e1->getTime();
-    float t2 = e2->getTime();
-    bool greater = (t1 - t2) > 0;
-    return greater;
+bool Event::greaterThan(const Event &e1, const Event &e2) {
+    return Event::compareKey(e1, e2) > 0;
 }
 
 // Compares if e1 < e2
-bool Event::lessThan(const Event *e1, const Event *e2) {
-    return !Event::greaterThan(e1, e2);
+bool Event::lessThan(const Event &e1, const Event &e2) {
+    return Event::compareKey(e1, e2) < 0;
 }
 
 QList<QString> Event::PenaltyTexts = QList<QString>()
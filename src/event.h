@@ -20,23 +20,15 @@
 #ifndef EVENT_H
 #define EVENT_H
 
-#include <QObject>
 #include <QString>
 #include <QList>
-#include <QMap>
+#include <QtGlobal>
 
 #include "player.h"
 
-class Event : public QObject {
-    Q_OBJECT
-
-    Q_PROPERTY(qlonglong mTeam READ getTeam CONSTANT)
-    Q_PROPERTY(QString time READ getTimeString CONSTANT)
-    Q_PROPERTY(QString player READ getPlayerString CONSTANT) // TODO: Should be migrated to getPlayer
-    Q_PROPERTY(QString info READ getInfo CONSTANT)
-    Q_PROPERTY(QString value READ getValue CONSTANT)
-    Q_PROPERTY(QString context READ getContext CONSTANT)
-
+// A game event (goal, penalty, etc.). Events are plain values that are stored
+// in the EventList and exposed to QML through its roles.
+class Event {
     public:
         enum EventType {
             GOAL = 1,
@@ -52,18 +44,24 @@ class Event : public QObject {
             FIRST_ASSIST,
             SECOND_ASSIST,
             PENALIZED,
-            GOALKEEPER
+            GOALKEEPER,
+            ROLE_LENGTH
         };
 
     private:
         // Stores the event type
         int mType;
 
-        // Stores the event time in seconds
-        float mTime;
+        // Stores the game time of the event in tenths of a second, and the
+        // sequence number of events at the same time (e.g. shootout shots)
+        quint32 mTime;
+        quint16 mSequence;
 
-        // List of players involved in this event
-        QMap<int, Player *> mPlayers;
+        // Stores the period the event belongs to (starting at 1)
+        quint8 mPeriod;
+
+        // Players involved in this event, by role
+        Player *mPlayers[ROLE_LENGTH];
 
         // Stores the ID of the team this event belongs to
         qlonglong mTeam;
@@ -83,21 +81,31 @@ class Event : public QObject {
         static QList<QString> PenaltyTexts;
 
     public:
-        explicit Event(int mType);
-        int getType(void);
-
-        void setTime(QString mTime);
-        float getTime(void) const;
+        explicit Event(int mType = 0);
+        int getType(void) const;
+
+        // Game time; the strings are formatted as 'mm:ss' or 'mm:ss.t'
+        static const quint32 TENTHS_PER_SECOND = 10;
+        static const quint32 TENTHS_PER_MINUTE = 60*TENTHS_PER_SECOND;
+        static quint32 parseTime(const QString &time);
+
+        void setTime(QString mTime, quint16 sequence = 0);
+        void setTime(quint32 tenths, quint16 sequence = 0);
+        quint32 getTime(void) const;
+        quint16 getSequence(void) const;
         QString getTimeString(void) const;
 
+        void setPeriod(quint8 period);
+        quint8 getPeriod(void) const;
+
         void setTeam(qlonglong mTeam);
-        qlonglong getTeam(void);
+        qlonglong getTeam(void) const;
 
         void addPlayer(int role, Player *player);
 
         void setScore(QString mScore, QString mType);
         void setPenalty(int id, QString mType);
-        int getPenalty(void);
+        int getPenalty(void) const;
         void setPenaltyShot(bool scored);
 
         Player *getPlayer(void) const;
@@ -108,9 +116,15 @@ class Event : public QObject {
         QString getInfo(void) const;
         QString getContext(void) const;
 
-        static bool greaterThan(const Event *e1, const Event *e2);
-        static bool lessThan(const Event *e1, const Event *e2);
+        bool operator==(const Event &other) const;
+        bool operator!=(const Event &other) const;
+
+        static int compareKey(const Event &e1, const Event &e2);
+        static bool greaterThan(const Event &e1, const Event &e2);
+        static bool lessThan(const Event &e1, const Event &e2);
         static QString getPenaltyText(int id);
 };
 
+Q_DECLARE_TYPEINFO(Event, Q_MOVABLE_TYPE);
+
 #endif // EVENT_H
@@ -20,8 +20,9 @@
 #include <algorithm>
 
 #include "eventlist.h"
+#include "logger.h"
 
-EventList::EventList(QObject *parent) : QAbstractListModel(parent) {
+EventList::EventList(QObject *parent) : QAbstractListModel(parent), mUpdateDepth(0) {
 }
 
 int EventList::rowCount(const QModelIndex &parent) const {
@@ -35,17 +36,160 @@ int EventList::rowCount(const QModelIndex &parent) const {
 }
 
 QVariant EventList::data(const QModelIndex &index, int role) const {
-    if (!index.isValid()) {
+    if (!index.isValid() || index.row() >= mEvents.size()) {
         return QVariant();
     }
-    Event *event = mEvents.at(index.row());
-    return QVariant::fromValue(event);
+
+    const Event &event = mEvents.at(index.row());
+    QVariant data;
+    switch(role) {
+        case TimeRole:
+            data = event.getTimeString();
+            break;
+
+        case PlayerRole:
+            data = event.getPlayerString();
+            break;
+
+        case InfoRole:
+            data = event.getInfo();
+            break;
+
+        case ValueRole:
+            data = event.getValue();
+            break;
+
+        case ContextRole:
+            data = event.getContext();
+            break;
+
+        case TeamRole:
+            data = event.getTeam();
+            break;
+
+        default:
+            break;
+    }
+
+    return data;
+}
+
+// Orders the events as they are shown, latest first
+bool EventList::isAfter(const Event &e1, const Event &e2) {
+    return Event::compareKey(e1, e2) > 0;
+}
+
+// Inserts an event at its position, or collects it if an update is in
+// progress
+void EventList::insert(const Event &event) {
+    if(mUpdateDepth > 0) {
+        mPendingEvents.append(event);
+    } else {
+        int row = std::upper_bound(mEvents.begin(), mEvents.end(), event, EventList::isAfter) - mEvents.begin();
+        beginInsertRows(QModelIndex(), row, row);
+        mEvents.insert(row, event);
+        endInsertRows();
+    }
+}
+
+void EventList::beginUpdate(void) {
+    if(mUpdateDepth == 0) {
+        mPendingEvents.clear();
+    }
+    mUpdateDepth++;
+}
+
+void EventList::endUpdate(void) {
+    if(mUpdateDepth == 0) {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::WARN, QString(Q_FUNC_INFO).append(": No update in progress."));
+        return;
+    }
+
+    mUpdateDepth--;
+    if(mUpdateDepth == 0) {
+        merge(mPendingEvents);
+        mPendingEvents.clear();
+    }
+}
+
+// Merges the given events into the list. Both lists are walked in order at
+// the same time, which keeps the events with the same key, and notifies the
+// views about each contiguous range of inserted or removed rows only.
+void EventList::merge(QVector<Event> &events) {
+    std::stable_sort(events.begin(), events.end(), EventList::isAfter);
+
+    int row = 0;
+    int next = 0;
+    while(row < mEvents.size() || next < events.size()) {
+        int order;
+        if(row >= mEvents.size()) {
+            order = 1;
+        } else if(next >= events.size()) {
+            order = -1;
+        } else {
+            order = Event::compareKey(events.at(next), mEvents.at(row));
+        }
+
+        if(order == 0) {
+            // Known event: keep it, but update the content if it changed
+            if(mEvents.at(row) != events.at(next)) {
+                mEvents[row] = events.at(next);
+                QModelIndex index = createIndex(row, 0);
+                emit dataChanged(index, index);
+            }
+            row++;
+            next++;
+        } else if(order > 0) {
+            // New event: insert it and all the following new events before
+            // the current row
+            int last = next + 1;
+            while(last < events.size() && (row >= mEvents.size() || Event::compareKey(events.at(last), mEvents.at(row)) > 0)) {
+                last++;
+            }
+            int count = last - next;
+            beginInsertRows(QModelIndex(), row, row + count - 1);
+            mEvents.insert(row, count, Event());
+            for(int i = next; i < last; i++) {
+                mEvents[row++] = events.at(i);
+            }
+            endInsertRows();
+            next = last;
+        } else {
+            // Missing event: remove it and all the following missing events
+            int last = row + 1;
+            while(last < mEvents.size() && (next >= events.size() || Event::compareKey(events.at(next), mEvents.at(last)) < 0)) {
+                last++;
+            }
+            beginRemoveRows(QModelIndex(), row, last - 1);
+            mEvents.remove(row, last - row);
+            endRemoveRows();
+        }
+    }
+}
+
+// Returns the events of the given period
+QVector<Event> EventList::getEventsInPeriod(quint8 period) const {
+    // The list is sorted latest first, so the events of later periods come
+    // before the requested ones
+    QVector<Event>::const_iterator first = std::partition_point(mEvents.constBegin(), mEvents.constEnd(), [period](const Event &event) {
+        return event.getPeriod() > period;
+    });
+    QVector<Event>::const_iterator last = std::partition_point(first, mEvents.constEnd(), [period](const Event &event) {
+        return event.getPeriod() == period;
+    });
+    return mEvents.mid(first - mEvents.constBegin(), last - first);
 }
 
-void EventList::insert(Event *event) {
-    beginInsertRows(QModelIndex(), 0, 0);
-    mEvents.append(event);
-    endInsertRows();
+// Returns the events with a game time in [from, to)
+QVector<Event> EventList::getEventsBetween(quint32 from, quint32 to) const {
+    QVector<Event>::const_iterator first = std::partition_point(mEvents.constBegin(), mEvents.constEnd(), [to](const Event &event) {
+        return event.getTime() >= to;
+    });
+    QVector<Event>::const_iterator last = std::partition_point(first, mEvents.constEnd(), [from](const Event &event) {
+        return event.getTime() >= from;
+    });
+    return mEvents.mid(first - mEvents.constBegin(), last - first);
 }
 
 void EventList::sort(int column, Qt::SortOrder order) {
@@ -66,6 +210,11 @@ void EventList::clear(void) {
 
 QHash<int, QByteArray> EventList::roleNames() const {
     QHash<int, QByteArray> roles;
-    roles[Qt::UserRole + 1] = "event";
+    roles[TimeRole] = "time";
+    roles[PlayerRole] = "player";
+    roles[InfoRole] = "info";
+    roles[ValueRole] = "value";
+    roles[ContextRole] = "context";
+    roles[TeamRole] = "team";
     return roles;
 }
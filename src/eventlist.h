@@ -28,8 +28,26 @@
 class EventList : public QAbstractListModel {
     Q_OBJECT
 
+    public:
+        enum EventRoles {
+            TimeRole = Qt::UserRole + 1,
+            PlayerRole,
+            InfoRole,
+            ValueRole,
+            ContextRole,
+            TeamRole
+        };
+
     private:
-        QVector<Event *> mEvents;
+        // The events are stored by value, latest first
+        QVector<Event> mEvents;
+
+        // Events collected while an update is in progress
+        int mUpdateDepth;
+        QVector<Event> mPendingEvents;
+
+        static bool isAfter(const Event &e1, const Event &e2);
+        void merge(QVector<Event> &events);
 
     protected:
         QHash<int, QByteArray> roleNames() const override;
@@ -45,10 +63,20 @@ class EventList : public QAbstractListModel {
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
         void sort(int column = 0, Qt::SortOrder order = Qt::DescendingOrder);
         void clear(void);
+        void insert(const Event &event);
+
+        // Updates: between beginUpdate() and endUpdate(), the inserted events
+        // are collected and then merged with the current ones by their key.
+        // Events that are already in the list are kept, new ones are inserted
+        // at their position, and the ones that are missing are removed.
+        void beginUpdate(void);
+        void endUpdate(void);
 
-    public slots:
-        void insert(Event *event);
-        //void remove(Event *event);
+        // Range queries over the events, which are kept sorted by period and
+        // time and hence looked up by binary search. The results are in the
+        // order of the list, latest first; times are in tenths of a second.
+        QVector<Event> getEventsInPeriod(quint8 period) const;
+        QVector<Event> getEventsBetween(quint32 from, quint32 to) const;
 };
 
 #endif // EVENTLIST_H
@@ -36,10 +36,45 @@ QStringList Game::GameStatusTexts = QStringList()
     << QString("Final (unofficial, shootout)")
     << QString("Final");
 
+// The statuses a game can change to, by current status (as bit masks): The
+// in-play statuses may be corrected in either direction, but a game doesn't
+// go back to not started, and an unofficial final result can only become
+// official (or be corrected to another unofficial one).
+namespace {
+    constexpr quint16 statusMask(int status) {
+        return 1u << status;
+    }
+
+    constexpr quint16 ANY_STATUS = (1u << Game::STATUS_LENGTH) - 1;
+    constexpr quint16 STARTED = ANY_STATUS & ~statusMask(Game::STATUS_NOT_STARTED);
+    constexpr quint16 FINALS = statusMask(Game::STATUS_FINAL_UNOFFICIAL) | statusMask(Game::STATUS_FINAL_UNOFFICIAL_OVERTIME)
+        | statusMask(Game::STATUS_FINAL_UNOFFICIAL_SHOOTOUT) | statusMask(Game::STATUS_FINAL);
+}
+
+const quint16 Game::STATUS_TRANSITIONS[Game::STATUS_LENGTH] = {
+    ANY_STATUS,                     // STATUS_NOT_STARTED
+    STARTED,                        // STATUS_FIRST_PERIOD
+    STARTED,                        // STATUS_FIRST_BREAK
+    STARTED,                        // STATUS_SECOND_PERIOD
+    STARTED,                        // STATUS_SECOND_BREAK
+    STARTED,                        // STATUS_THIRD_PERIOD
+    STARTED,                        // STATUS_THIRD_BREAK
+    STARTED,                        // STATUS_OVERTIME
+    STARTED,                        // STATUS_SHOOTOUT
+    FINALS,                         // STATUS_FINAL_UNOFFICIAL
+    FINALS,                         // STATUS_FINAL_UNOFFICIAL_OVERTIME
+    FINALS,                         // STATUS_FINAL_UNOFFICIAL_SHOOTOUT
+    statusMask(Game::STATUS_FINAL)  // STATUS_FINAL
+};
+
 // Initialize the game
 Game::Game(QString gameId, QObject *parent) : QObject(parent) {
     // Store game ID
     mGameId = gameId;
+    mGameStatus = STATUS_NOT_STARTED;
+    mHometeamId = 0;
+    mAwayteamId = 0;
+    updateStatusString();
 }
 
 QString Game::getGameId(void){
@@ -56,10 +91,25 @@ QString Game::getLeague() {
 
 void Game::setDateTime(QString time) {
     mStartTime = time;
+    updateStatusString();
+}
+
+// The summaries only contain the time of today's games, hence we assume
+// the current date if there is none.
+QDateTime Game::getStartDateTime(void) {
+    QDateTime startTime = QDateTime::fromString(mStartTime, Qt::ISODate);
+    if(!startTime.isValid()) {
+        QTime time = QTime::fromString(mStartTime, "HH:mm");
+        if(time.isValid()) {
+            startTime = QDateTime(QDate::currentDate(), time);
+        }
+    }
+    return startTime;
 }
 
 void Game::setHometeam(QString id, QString name) {
     mHometeamId = id.toLongLong();
+    mHometeamIdString = QString::number(mHometeamId);
     mHometeamName = name;
 }
 
@@ -68,11 +118,12 @@ QString Game::getHometeam() {
 }
 
 QString Game::getHometeamId() {
-    return QString::number(this->mHometeamId);
+    return mHometeamIdString;
 }
 
 void Game::setAwayteam(QString id, QString name) {
     mAwayteamId = id.toLongLong();
+    mAwayteamIdString = QString::number(mAwayteamId);
     mAwayteamName = name;
 }
 
@@ -81,54 +132,80 @@ QString Game::getAwayteam() {
 }
 
 QString Game::getAwayteamId() {
-    return QString::number(this->mAwayteamId);
+    return mAwayteamIdString;
 }
 
-void Game::setScore(QMap<QString, QString> score) {
-    // Update the score and trigger a signal if it changed
-    QMap<QString, QString> oldScore = mScore;
+void Game::setScore(const GameScore &score) {
+    if(score == mScore) {
+        return;
+    }
+
+    // Update the score and trigger a signal if the total changed (but not when
+    // the first known score replaces the unknown one)
+    bool notify = !score.hasSameTotal(mScore) && (!mScore.hasFlag(GameScore::FLAG_SET) || mScore.isTotalKnown());
     mScore = score;
-    if(mScore["total"] != oldScore["total"] && oldScore["total"] != "-:-") {
+    emit scoreTextChanged();
+    if(notify) {
         emit scoreChanged();
     }
 }
 
+const GameScore &Game::getScore(void) const {
+    return mScore;
+}
+
 QString Game::getTotalScore() {
-    return this->mScore["total"];
+    return mScore.getTotalText();
 }
 
 QString Game::getPeriodsScore() {
-    QString score = mScore.value("first") + ", " + mScore.value("second") + ", " + mScore.value("third");
+    return mScore.getPeriodsText();
+}
 
-    if(mScore.contains("overtime")) {
-        score.append(", " + this->mScore.value("overtime"));
+bool Game::setStatus(GAME_STATUS status) {
+    if(!isValidTransition(mGameStatus, status)) {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Game " + mGameId + " can't change from status " + QString::number(mGameStatus) + " to "
+            + QString::number(status) + ", ignoring."));
+        return false;
     }
 
-    return score;
-}
-
-void Game::setStatus(int status) {
     // Update the game status and trigger a signal if it changed
-    int oldStatus = mGameStatus;
+    GAME_STATUS oldStatus = mGameStatus;
     mGameStatus = status;
     if(mGameStatus != oldStatus) {
+        updateStatusString();
         emit statusChanged();
     }
+    return true;
 }
 
-int Game::getStatus() {
+Game::GAME_STATUS Game::getStatus() {
     return this->mGameStatus;
 }
 
+// True from the first faceoff until the game is (unofficially) final
+bool Game::isInProgress() {
+    return mGameStatus > STATUS_NOT_STARTED && mGameStatus < STATUS_FINAL_UNOFFICIAL;
+}
+
+bool Game::isValidTransition(GAME_STATUS from, GAME_STATUS to) {
+    if(from < 0 || from >= STATUS_LENGTH || to < 0 || to >= STATUS_LENGTH) {
+        return false;
+    }
+    return (STATUS_TRANSITIONS[from] & (1u << to)) != 0;
+}
+
 QString Game::getStatusString() {
-    QString text;
-    if(this->mGameStatus == 0) {
-        text = "Starts " + this->mStartTime;
+    return mStatusString;
+}
+
+void Game::updateStatusString(void) {
+    if(this->mGameStatus == STATUS_NOT_STARTED) {
+        mStatusString = "Starts " + this->mStartTime;
     } else {
-        text = Game::GameStatusTexts.value(this->mGameStatus, "Unknown status");
+        mStatusString = Game::GameStatusTexts.value(this->mGameStatus, "Unknown status");
     }
-
-    return text;
 }
 
 EventList *Game::getEventList(void) {
@@ -22,9 +22,11 @@
 
 #include <QObject>
 #include <QString>
+#include <QDateTime>
 
 #include "eventlist.h"
 #include "event.h"
+#include "gamescore.h"
 
 #include "playerlist.h"
 #include "player.h"
@@ -32,40 +34,64 @@
 class Game : public QObject {
     Q_OBJECT
 
+    public:
+        // The phases of a game, in the order they normally happen
+        enum GAME_STATUS {
+            STATUS_NOT_STARTED = 0,
+            STATUS_FIRST_PERIOD,
+            STATUS_FIRST_BREAK,
+            STATUS_SECOND_PERIOD,
+            STATUS_SECOND_BREAK,
+            STATUS_THIRD_PERIOD,
+            STATUS_THIRD_BREAK,
+            STATUS_OVERTIME,
+            STATUS_SHOOTOUT,
+            STATUS_FINAL_UNOFFICIAL,
+            STATUS_FINAL_UNOFFICIAL_OVERTIME,
+            STATUS_FINAL_UNOFFICIAL_SHOOTOUT,
+            STATUS_FINAL,
+            STATUS_LENGTH
+        };
+
     Q_PROPERTY(QString hometeamId READ getHometeamId CONSTANT)
     Q_PROPERTY(QString hometeamName READ getHometeam CONSTANT)
     Q_PROPERTY(QString awayteamId READ getAwayteamId CONSTANT)
     Q_PROPERTY(QString awayteamName READ getAwayteam CONSTANT)
-    Q_PROPERTY(QString totalScore READ getTotalScore NOTIFY scoreChanged)
-    Q_PROPERTY(QString periodsScore READ getPeriodsScore NOTIFY scoreChanged)
+    Q_PROPERTY(QString totalScore READ getTotalScore NOTIFY scoreTextChanged)
+    Q_PROPERTY(QString periodsScore READ getPeriodsScore NOTIFY scoreTextChanged)
     Q_PROPERTY(int gameStatus READ getStatus NOTIFY statusChanged)
 
     private:
         QString mGameId;
         QString mLeagueId;
 
-        // Home- and away team names & IDs
+        // Home- and away team names & IDs (and the IDs as displayed)
         QString mHometeamName;
         qulonglong mHometeamId;
+        QString mHometeamIdString;
         QString mAwayteamName;
         qulonglong mAwayteamId;
+        QString mAwayteamIdString;
 
         // Time
         QString mStartTime;
 
         // Score
-        QMap<QString, QString> mScore;
+        GameScore mScore;
 
         // List of events and rosters
         EventList mEventList;
         PlayerList mHometeamRoster;
         PlayerList mAwayteamRoster;
 
-        // Status
-        // TODO: There should be a (public) enum with statuses, which are rendered in the UI to plain text
-        int mGameStatus;
+        // Status, and its text which is updated whenever it changes
+        GAME_STATUS mGameStatus;
+        QString mStatusString;
+
+        void updateStatusString(void);
 
         static QStringList GameStatusTexts;
+        static const quint16 STATUS_TRANSITIONS[STATUS_LENGTH];
 
     public:
         explicit Game(QString gameId, QObject *parent = 0);
@@ -79,6 +105,7 @@ class Game : public QObject {
         QString getLeague();
 
         void setDateTime(QString time);
+        QDateTime getStartDateTime(void);
 
         void setHometeam(QString id, QString name);
         QString getHometeam();
@@ -88,20 +115,28 @@ class Game : public QObject {
         QString getAwayteam();
         QString getAwayteamId();
 
-        void setScore(QMap<QString, QString> score);
+        void setScore(const GameScore &score);
+        const GameScore &getScore(void) const;
         QString getTotalScore();
         QString getPeriodsScore();
 
-        void setStatus(int status);
-        int getStatus();
+        // Returns false (and keeps the current status) if the game can't
+        // change from the current to the new status, e.g. once it's final
+        bool setStatus(GAME_STATUS status);
+        GAME_STATUS getStatus();
+        bool isInProgress();
         QString getStatusString();
+        static bool isValidTransition(GAME_STATUS from, GAME_STATUS to);
 
         EventList *getEventList(void);
         PlayerList *getHometeamRoster(void);
         PlayerList *getAwayteamRoster(void);
 
     signals:
+        // scoreChanged() is only emitted when the total changes (i.e. for
+        // goals), scoreTextChanged() whenever anything about the score does
         void scoreChanged(void);
+        void scoreTextChanged(void);
         void statusChanged(void);
 };
 
@@ -22,7 +22,7 @@
 #include "gamelist.h"
 #include "logger.h"
 
-GameList::GameList(QObject *parent) : QAbstractListModel(parent) {
+GameList::GameList(QObject *parent) : QAbstractListModel(parent), mUpdateDepth(0) {
     // Initialize the different data roles that can be used by the ListView
     this->mRoles[HometeamRole] = "hometeam";
     this->mRoles[HometeamIdRole] = "hometeamId";
@@ -37,53 +37,135 @@ GameList::GameList(QObject *parent) : QAbstractListModel(parent) {
     // Set the date to <empty>
     // TODO: We should probably work with DateTime instead of strings
     this->mDate = QDate::currentDate().toString("yyyy-MM-dd");;
+}
+
+// Notifies the views about a change of the given roles of a game. Within an
+// update batch, the roles are only recorded for the row; games that are still
+// pending insertion are skipped since the views will read them as a whole.
+void GameList::notifyGameChanged(Game *game, const QVector<int> &roles) {
+    int row = mRows.value(game, -1);
+    if(row < 0) {
+        return;
+    }
+
+    if(mUpdateDepth > 0) {
+        quint32 mask = 0;
+        QVectorIterator<int> iter(roles);
+        while(iter.hasNext()) {
+            mask |= 1u << (iter.next() - Qt::UserRole);
+        }
+        mPendingChanges[row] |= mask;
+    } else {
+        QModelIndex index = createIndex(row, 0);
+        emit dataChanged(index, index, roles);
+    }
+}
+
+void GameList::gameScoreChanged(void) {
+    static const QVector<int> roles = QVector<int>() << TotalScoreRole << PeriodsScoreRole;
+    notifyGameChanged(qobject_cast<Game *>(sender()), roles);
+}
+
+void GameList::gameStatusChanged(void) {
+    static const QVector<int> roles = QVector<int>() << GameStatusRole;
+    notifyGameChanged(qobject_cast<Game *>(sender()), roles);
+}
+
+void GameList::beginUpdate(void) {
+    mUpdateDepth++;
+}
 
-    // Signal mapper acts as a proxy between the GameData -> GamedayData -> outside world
-    this->mSignalMapper = new QSignalMapper(this);
-    connect(this->mSignalMapper, SIGNAL(mapped(const QString &)), this, SLOT(gamedataChanged(const QString &)));
+void GameList::endUpdate(void) {
+    if(mUpdateDepth == 0) {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::WARN, QString(Q_FUNC_INFO).append(": No update in progress."));
+        return;
+    }
+
+    mUpdateDepth--;
+    if(mUpdateDepth == 0) {
+        publishPendingChanges();
+    }
 }
 
-void GameList::gamedataChanged(const QString & key) {
-    QModelIndex index = createIndex(this->mGameIndices.indexOf(key.toLongLong()), 0);
-    emit dataChanged(index, index);
+// Publishes the changes collected during an update batch: first all the new
+// games as one contiguous insert range, then the changed rows, coalesced into
+// one dataChanged() per contiguous range with the union of the changed roles
+void GameList::publishPendingChanges(void) {
+    if(!mPendingGames.isEmpty()) {
+        int first = mGames.size();
+        beginInsertRows(QModelIndex(), first, first + mPendingGames.size() - 1);
+        for(int i = 0; i < mPendingGames.size(); i++) {
+            mRows.insert(mPendingGames.at(i), first + i);
+        }
+        mGames += mPendingGames;
+        endInsertRows();
+        mPendingGames.clear();
+    }
+
+    QMapIterator<int, quint32> iter(mPendingChanges);
+    while(iter.hasNext()) {
+        iter.next();
+        int first = iter.key();
+        int last = first;
+        quint32 mask = iter.value();
+        while(iter.hasNext() && iter.peekNext().key() == last + 1) {
+            iter.next();
+            last++;
+            mask |= iter.value();
+        }
+
+        QVector<int> roles;
+        for(int role = HometeamRole; role <= LeagueRole; role++) {
+            if(mask & (1u << (role - Qt::UserRole))) {
+                roles.append(role);
+            }
+        }
+        emit dataChanged(createIndex(first, 0), createIndex(last, 0), roles);
+    }
+    mPendingChanges.clear();
 }
 
 void GameList::addGame(Game *game) {
     // TODO: Add debuggin information
 
     qulonglong key = game->getGameId().toULongLong();
-    if(!mGames.contains(key)) {
+    if(!mGamesById.contains(key)) {
         // A game with the given ID is not in the list yet and hence, we add
         // it. For that, we need to call beginInsertRows() and endInsertRows()
-        // so that the ListView gets notified about the new content.
-        beginInsertRows(QModelIndex(), rowCount(), rowCount());
-        mGames.insert(key, game);
-        mGameIndices.append(key);
-        endInsertRows();
-
-        // Listen to the scoreChanged()- and statusChanged()-signals to know
-        // when we need to notify the view through the dataChanged()-signal.
-        // We have to do this through the SignalMapper because GameData's
-        // signals don't take arguments but we need to be able to identify
-        // the sender in GamedayData (and the views).
-        connect(mGames[key], SIGNAL(scoreChanged()), mSignalMapper, SLOT(map()));
-        connect(mGames[key], SIGNAL(statusChanged()), mSignalMapper, SLOT(map()));
-        mSignalMapper->setMapping(mGames[key], QString::number(key));
+        // so that the ListView gets notified about the new content. Within an
+        // update batch, the game can already be found by its ID but is only
+        // added to the rows when the batch is published.
+        mGamesById.insert(key, game);
+        if(mUpdateDepth > 0) {
+            mPendingGames.append(game);
+        } else {
+            beginInsertRows(QModelIndex(), rowCount(), rowCount());
+            mRows.insert(game, mGames.size());
+            mGames.append(game);
+            endInsertRows();
+        }
+
+        // Listen to the scoreTextChanged()- and statusChanged()-signals to
+        // know when we need to notify the view through the dataChanged()-
+        // signal. The row of the game is looked up from the sender, and only
+        // the roles affected by the change are reported. Note that
+        // scoreChanged() isn't enough: It's only emitted when the total
+        // changes, but the periods (or an unknown total) change on their own.
+        connect(game, SIGNAL(scoreTextChanged()), this, SLOT(gameScoreChanged()));
+        connect(game, SIGNAL(statusChanged()), this, SLOT(gameStatusChanged()));
     } else {
         // NOP
     }
 }
 
 Game* GameList::getGame(QString gameId) {
-    qulonglong key = gameId.toULongLong();
-    Game *game;
-    if(this->mGames.contains(key)) {
-        game = mGames[key];
-    } else {
-        game = NULL;
-    }
+    return mGamesById.value(gameId.toULongLong(), NULL);
+}
 
-    return game;
+// Returns all the games in the order they appear in the list
+QList<Game *> GameList::getGames(void) const {
+    return mGames.toList();
 }
 
 // Impelementation of QAbstractListModel follows below
@@ -96,44 +178,46 @@ int GameList::rowCount(const QModelIndex &parent) const {
 QVariant GameList::data(const QModelIndex &index, int role) const {
     QVariant data;
 
-    // Map from the ListView index to the game key
-    qulonglong key = this->mGameIndices[index.row()];
+    if(!index.isValid() || index.row() >= mGames.size()) {
+        return data;
+    }
+    Game *game = this->mGames.at(index.row());
 
     switch(role) {
         case HometeamRole:
-            data = this->mGames[key]->getHometeam();
+            data = game->getHometeam();
             break;
 
         case HometeamIdRole:
-            data = this->mGames[key]->getHometeamId();
+            data = game->getHometeamId();
             break;
 
         case AwayteamRole:
-            data = this->mGames[key]->getAwayteam();
+            data = game->getAwayteam();
             break;
 
         case AwayteamIdRole:
-            data = this->mGames[key]->getAwayteamId();
+            data = game->getAwayteamId();
             break;
 
         case TotalScoreRole:
-            data = this->mGames[key]->getTotalScore();
+            data = game->getTotalScore();
             break;
 
         case PeriodsScoreRole:
-            data = this->mGames[key]->getPeriodsScore();
+            data = game->getPeriodsScore();
             break;
 
         case GameStatusRole:
-            data = this->mGames[key]->getStatusString();
+            data = game->getStatusString();
             break;
 
         case GameIdRole:
-            data = QString::number(key);
+            data = game->getGameId();
             break;
 
         case LeagueRole:
-        data = this->mGames[key]->getLeague();
+            data = game->getLeague();
             break;
 
         default:
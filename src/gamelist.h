@@ -21,7 +21,9 @@
 #define GAMELIST_H
 
 #include <QAbstractListModel>
-#include <QSignalMapper>
+#include <QHash>
+#include <QMap>
+#include <QVector>
 
 #include "game.h"
 
@@ -35,10 +37,24 @@ class GameList : public QAbstractListModel {
 
     private:
         QHash<int, QByteArray> mRoles;
-        QMap<qulonglong, Game *> mGames;
-        QList<qulonglong> mGameIndices;
+
+        // The games in the order of the rows, and the indexes to find a game
+        // by its ID and the row of a game
+        QVector<Game *> mGames;
+        QHash<qulonglong, Game *> mGamesById;
+        QHash<Game *, int> mRows;
+
         QString mDate; // TODO: This should be part of the Games, then we wouldn't have to bother about keeping different games. Could also add filters for the games later on.
-        QSignalMapper *mSignalMapper;
+
+        // Pending changes while an update batch is open: the games to be
+        // appended and the changed roles of the existing rows (as a bitmask
+        // of the role offset to Qt::UserRole), by row
+        int mUpdateDepth;
+        QVector<Game *> mPendingGames;
+        QMap<int, quint32> mPendingChanges;
+
+        void notifyGameChanged(Game *game, const QVector<int> &roles);
+        void publishPendingChanges(void);
 
     public:
         explicit GameList(QObject *parent = 0);
@@ -46,8 +62,16 @@ class GameList : public QAbstractListModel {
         // date: date of the gameday, data: the list of games
         void updateGames(QString date, QVariantMap data);
 
+        // Update batches: between beginUpdate() and endUpdate(), added games
+        // and changed roles are collected and then published as one insert
+        // range and one dataChanged() per contiguous range of changed rows.
+        // Batches may be nested; only the outermost endUpdate() publishes.
+        void beginUpdate(void);
+        void endUpdate(void);
+
         void addGame(Game *game);
         Game *getGame(QString gameId);
+        QList<Game *> getGames(void) const;
 
         // implementations of interface QAbstractListModel
         enum GameRoles {
@@ -67,7 +91,8 @@ class GameList : public QAbstractListModel {
         QHash<int, QByteArray> roleNames() const;
 
     public slots:
-        void gamedataChanged(const QString & key);
+        void gameScoreChanged(void);
+        void gameStatusChanged(void);
 };
 
 #endif // GAMELIST_H
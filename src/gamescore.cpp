@@ -0,0 +1,118 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <cstring>
+
+#include <QtGlobal>
+
+#include "gamescore.h"
+
+const int GameScore::UNKNOWN;
+
+GameScore::GameScore(void) : mTextCached(false) {
+    memset(&mGoals, 0, sizeof(mGoals));
+    for(int field = 0; field < SCORE_LENGTH; field++) {
+        mGoals.home[field] = UNKNOWN;
+        mGoals.away[field] = UNKNOWN;
+    }
+}
+
+void GameScore::setGoals(int field, int home, int away) {
+    if(field < 0 || field >= SCORE_LENGTH) {
+        return;
+    }
+
+    mGoals.home[field] = qBound(UNKNOWN, home, 127);
+    mGoals.away[field] = qBound(UNKNOWN, away, 127);
+    mGoals.flags |= FLAG_SET;
+    mTextCached = false;
+}
+
+int GameScore::getHomeGoals(int field) const {
+    return (field >= 0 && field < SCORE_LENGTH) ? mGoals.home[field] : UNKNOWN;
+}
+
+int GameScore::getAwayGoals(int field) const {
+    return (field >= 0 && field < SCORE_LENGTH) ? mGoals.away[field] : UNKNOWN;
+}
+
+void GameScore::setFlag(SCORE_FLAGS flag, bool set) {
+    if(set) {
+        mGoals.flags |= flag;
+    } else {
+        mGoals.flags &= ~flag;
+    }
+    mTextCached = false;
+}
+
+bool GameScore::hasFlag(SCORE_FLAGS flag) const {
+    return (mGoals.flags & flag) != 0;
+}
+
+bool GameScore::hasSameTotal(const GameScore &other) const {
+    return mGoals.home[SCORE_TOTAL] == other.mGoals.home[SCORE_TOTAL] && mGoals.away[SCORE_TOTAL] == other.mGoals.away[SCORE_TOTAL];
+}
+
+bool GameScore::isTotalKnown(void) const {
+    return mGoals.home[SCORE_TOTAL] != UNKNOWN || mGoals.away[SCORE_TOTAL] != UNKNOWN;
+}
+
+const QString &GameScore::getTotalText(void) const {
+    updateText();
+    return mTotalText;
+}
+
+const QString &GameScore::getPeriodsText(void) const {
+    updateText();
+    return mPeriodsText;
+}
+
+void GameScore::updateText(void) const {
+    if(mTextCached) {
+        return;
+    }
+
+    mTotalText = toText(mGoals.home[SCORE_TOTAL], mGoals.away[SCORE_TOTAL]);
+    mPeriodsText = toText(mGoals.home[SCORE_FIRST], mGoals.away[SCORE_FIRST])
+        + ", " + toText(mGoals.home[SCORE_SECOND], mGoals.away[SCORE_SECOND])
+        + ", " + toText(mGoals.home[SCORE_THIRD], mGoals.away[SCORE_THIRD]);
+    if(hasFlag(FLAG_OVERTIME_PLAYED)) {
+        mPeriodsText.append(", " + toText(mGoals.home[SCORE_OVERTIME], mGoals.away[SCORE_OVERTIME]));
+    }
+    mTextCached = true;
+}
+
+QString GameScore::toText(qint8 home, qint8 away) {
+    return (home == UNKNOWN ? QString("-") : QString::number(home)) + ":"
+        + (away == UNKNOWN ? QString("-") : QString::number(away));
+}
+
+bool GameScore::operator==(const GameScore &other) const {
+    return memcmp(&mGoals, &other.mGoals, sizeof(mGoals)) == 0;
+}
+
+bool GameScore::operator!=(const GameScore &other) const {
+    return !(*this == other);
+}
+
+int GameScore::parseGoals(const QString &text) {
+    bool ok = false;
+    int goals = text.toInt(&ok);
+    return (ok && goals >= 0) ? goals : UNKNOWN;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef GAMESCORE_H
+#define GAMESCORE_H
+
+#include <QString>
+
+// The score of a game: The goals of both teams per period and in total, and
+// how the game was decided. The goals are kept in a small fixed-size record
+// that is compared as a whole; the display strings are only put together when
+// they're requested and then cached until the score changes.
+class GameScore {
+    public:
+        enum SCORE_FIELDS {
+            SCORE_FIRST = 0,
+            SCORE_SECOND,
+            SCORE_THIRD,
+            SCORE_OVERTIME,
+            SCORE_TOTAL,
+            SCORE_LENGTH
+        };
+
+        enum SCORE_FLAGS {
+            FLAG_SET = 0x01,
+            FLAG_OVERTIME_PLAYED = 0x02,
+            FLAG_DECIDED_OVERTIME = 0x04,
+            FLAG_DECIDED_SHOOTOUT = 0x08
+        };
+
+        // Number of goals if the score isn't known (yet)
+        static const int UNKNOWN = -1;
+
+    private:
+        // Plain bytes only, so that it can be compared with memcmp()
+        struct Goals {
+            qint8 home[SCORE_LENGTH];
+            qint8 away[SCORE_LENGTH];
+            quint8 flags;
+        };
+
+        Goals mGoals;
+
+        mutable bool mTextCached;
+        mutable QString mTotalText;
+        mutable QString mPeriodsText;
+
+        void updateText(void) const;
+        static QString toText(qint8 home, qint8 away);
+
+    public:
+        GameScore(void);
+
+        void setGoals(int field, int home, int away);
+        int getHomeGoals(int field) const;
+        int getAwayGoals(int field) const;
+
+        void setFlag(SCORE_FLAGS flag, bool set = true);
+        bool hasFlag(SCORE_FLAGS flag) const;
+
+        // True if the total is the same, including when it's unknown
+        bool hasSameTotal(const GameScore &other) const;
+        bool isTotalKnown(void) const;
+
+        // Display strings, e.g. "2:1" and "1:0, 0:1, 1:0"
+        const QString &getTotalText(void) const;
+        const QString &getPeriodsText(void) const;
+
+        bool operator==(const GameScore &other) const;
+        bool operator!=(const GameScore &other) const;
+
+        // Number of goals from the data sources, UNKNOWN if it's not a number
+        static int parseGoals(const QString &text);
+};
+
+#endif // GAMESCORE_H
@@ -19,18 +19,134 @@
 
 #include "jsondecoder.h"
 
-JsonDecoder::JsonDecoder(QObject *parent) : QObject(parent) {
+JsonDecoder::JsonDecoder(QObject *parent) : QObject(parent), mParser(this), mComplete(false) {
 }
 
-QMap<QString, QVariant> JsonDecoder::decode(QByteArray json) {
-    QMap<QString, QVariant> map;
-    QJsonDocument document = QJsonDocument::fromJson(json);
+void JsonDecoder::reset(void) {
+    mParser.reset();
+    mPath.clear();
+    mComplete = false;
+    clear();
+}
+
+void JsonDecoder::feed(const QByteArray &data) {
+    mParser.feed(data);
+}
+
+// Returns true if a complete document was decoded
+bool JsonDecoder::finish(void) {
+    return mParser.finish();
+}
+
+bool JsonDecoder::hasError(void) const {
+    return mParser.hasError();
+}
+
+bool JsonDecoder::isComplete(void) const {
+    return mComplete;
+}
+
+void JsonDecoder::complete(void) {
+    mComplete = finish();
+    emit completed(this);
+}
+
+void JsonDecoder::setRequest(const QString &key, const QUrl &url) {
+    mRequestKey = key;
+    mRequestUrl = url;
+}
+
+QString JsonDecoder::getRequestKey(void) const {
+    return mRequestKey;
+}
+
+QUrl JsonDecoder::getRequestUrl(void) const {
+    return mRequestUrl;
+}
+
+int JsonDecoder::getDepth(void) const {
+    return mPath.size();
+}
+
+const QString &JsonDecoder::getKey(int level) const {
+    return mPath.at(level).key;
+}
+
+int JsonDecoder::getIndex(int level) const {
+    return mPath.at(level).index;
+}
+
+void JsonDecoder::beginContainer(bool isObject) {
+    Q_UNUSED(isObject);
+}
+
+void JsonDecoder::endContainer(bool isObject) {
+    Q_UNUSED(isObject);
+}
 
-    if(document.isObject()) {
-        map = document.object().toVariantMap();
-    } else if(document.isArray()) {
-        //map = document.array().to
+// Moves on to the next element if the current token is inside an array
+void JsonDecoder::advance(void) {
+    if(!mPath.isEmpty() && !mPath.last().isObject) {
+        mPath.last().index++;
     }
+}
+
+void JsonDecoder::startObject(void) {
+    advance();
+    beginContainer(true);
+
+    Frame frame;
+    frame.isObject = true;
+    frame.index = -1;
+    mPath.append(frame);
+}
+
+void JsonDecoder::endObject(void) {
+    mPath.removeLast();
+    endContainer(true);
+}
+
+void JsonDecoder::startArray(void) {
+    advance();
+    beginContainer(false);
+
+    Frame frame;
+    frame.isObject = false;
+    frame.index = -1;
+    mPath.append(frame);
+}
+
+void JsonDecoder::endArray(void) {
+    mPath.removeLast();
+    endContainer(false);
+}
+
+void JsonDecoder::key(const QString &key) {
+    mPath.last().key = key;
+    mPath.last().index++;
+}
+
+void JsonDecoder::string(const QString &value) {
+    advance();
+    this->value(value);
+}
+
+void JsonDecoder::integer(qlonglong value) {
+    advance();
+    this->value(value);
+}
+
+void JsonDecoder::number(double value) {
+    advance();
+    this->value(value);
+}
+
+void JsonDecoder::boolean(bool value) {
+    advance();
+    this->value(value);
+}
 
-    return map;
+void JsonDecoder::null(void) {
+    advance();
+    value(QVariant());
 }
@@ -22,23 +22,92 @@
 
 #include <QObject>
 #include <QString>
+#include <QUrl>
 #include <QVariant>
-#include <QMap>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QVector>
 
-// Wrapper to provide a unique decoder interface to the client
-class JsonDecoder : public QObject {
+#include "jsonstreamparser.h"
+
+// Base class for the decoders that turn the token stream of a response into
+// typed records. The data is fed chunk by chunk as it arrives; the decoder
+// keeps track of where in the document the current token is (getDepth(),
+// getKey(), getIndex()) and passes the values to the subclass without ever
+// building an intermediate tree.
+class JsonDecoder : public QObject, private JsonHandler {
     Q_OBJECT
 
+    private:
+        // Objects and arrays enclosing the current token
+        struct Frame {
+            bool isObject;
+            QString key;
+            int index;
+        };
+
+        JsonStreamParser mParser;
+        QVector<Frame> mPath;
+
+        // Result of finish() when completed on the parser thread
+        bool mComplete;
+
+        // The request the response belongs to
+        QString mRequestKey;
+        QUrl mRequestUrl;
+
+        void advance(void);
+
+        // Implementation of JsonHandler
+        void startObject(void);
+        void endObject(void);
+        void startArray(void);
+        void endArray(void);
+        void key(const QString &key);
+        void string(const QString &value);
+        void integer(qlonglong value);
+        void number(double value);
+        void boolean(bool value);
+        void null(void);
+
+    protected:
+        // Location of the current token: the number of enclosing containers
+        // and, for each of them, the current key (objects) and the index of
+        // the element (arrays) or key (objects)
+        int getDepth(void) const;
+        const QString &getKey(int level) const;
+        int getIndex(int level) const;
+
+        // Called for the start and end of every object and array as well as
+        // for every scalar value
+        virtual void beginContainer(bool isObject);
+        virtual void endContainer(bool isObject);
+        virtual void value(const QVariant &value) = 0;
+
+        // Discards the decoded records
+        virtual void clear(void) = 0;
+
     public:
         explicit JsonDecoder(QObject *parent = 0);
-        QMap<QString, QVariant> decode(QByteArray json);
+
+        void reset(void);
+        bool finish(void);
+        bool hasError(void) const;
+
+        // True if complete() found a complete document; the records of an
+        // incomplete one must not be applied
+        bool isComplete(void) const;
+
+        void setRequest(const QString &key, const QUrl &url);
+        QString getRequestKey(void) const;
+        QUrl getRequestUrl(void) const;
 
     signals:
+        void completed(JsonDecoder *decoder);
 
     public slots:
+        void feed(const QByteArray &data);
 
+        // Finishes decoding and emits completed()
+        void complete(void);
 };
 
 #endif // JSONDECODER_H
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JSONSCANNER_X86
+#include <immintrin.h>
+#endif
+
+#include "jsonscanner.h"
+
+// Portable fallback, also used for the tails that don't fill a whole block
+static const char *scanScalar(const char *begin, const char *end, const char *set, int size, bool negate) {
+    for(const char *position = begin; position < end; position++) {
+        bool found = false;
+        for(int i = 0; i < size; i++) {
+            found |= (*position == set[i]);
+        }
+        if(found != negate) {
+            return position;
+        }
+    }
+    return end;
+}
+
+#ifdef JSONSCANNER_X86
+// SSE4.2: PCMPESTRI compares each of the 16 bytes of a block against the
+// whole set at once and returns the index of the first (non-)match
+__attribute__((target("sse4.2")))
+static const char *scanSSE42(const char *begin, const char *end, const char *set, int size, bool negate) {
+    char setBuffer[16] = {0};
+    for(int i = 0; i < size && i < 16; i++) {
+        setBuffer[i] = set[i];
+    }
+    __m128i needles = _mm_loadu_si128((const __m128i *) setBuffer);
+
+    const char *position = begin;
+    while(end - position >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) position);
+        int index;
+        if(negate) {
+            index = _mm_cmpestri(needles, size, block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+        } else {
+            index = _mm_cmpestri(needles, size, block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+        }
+        if(index < 16) {
+            return position + index;
+        }
+        position += 16;
+    }
+    return scanScalar(position, end, set, size, negate);
+}
+
+// AVX2: Classifies 32 bytes at a time into a bit mask with one bit per byte
+// that is in the set; the first (non-)match is the lowest (un)set bit
+__attribute__((target("avx2")))
+static const char *scanAVX2(const char *begin, const char *end, const char *set, int size, bool negate) {
+    __m256i needles[16];
+    size = (size < 16) ? size : 16;
+    for(int i = 0; i < size; i++) {
+        needles[i] = _mm256_set1_epi8(set[i]);
+    }
+
+    const char *position = begin;
+    while(end - position >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) position);
+        __m256i matches = _mm256_setzero_si256();
+        for(int i = 0; i < size; i++) {
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, needles[i]));
+        }
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(matches);
+        if(negate) {
+            mask = ~mask;
+        }
+        if(mask != 0) {
+            return position + __builtin_ctz(mask);
+        }
+        position += 32;
+    }
+    return scanScalar(position, end, set, size, negate);
+}
+#endif
+
+const char *JsonScanner::findFirstOf(const char *begin, const char *end, const char *set, int size) {
+    return getInstance().scan(begin, end, set, size, false);
+}
+
+const char *JsonScanner::findFirstNotOf(const char *begin, const char *end, const char *set, int size) {
+    return getInstance().scan(begin, end, set, size, true);
+}
+
+const char *JsonScanner::getImplementation(void) {
+    return getInstance().name;
+}
+
+// The implementation is selected once, upon the first use
+const JsonScanner::Implementation &JsonScanner::getInstance(void) {
+    static const Implementation instance = select();
+    return instance;
+}
+
+JsonScanner::Implementation JsonScanner::select(void) {
+    Implementation implementation;
+    implementation.name = "scalar";
+    implementation.scan = scanScalar;
+
+#ifdef JSONSCANNER_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        implementation.name = "avx2";
+        implementation.scan = scanAVX2;
+    } else if(__builtin_cpu_supports("sse4.2")) {
+        implementation.name = "sse4.2";
+        implementation.scan = scanSSE42;
+    }
+#endif
+
+    return implementation;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef JSONSCANNER_H
+#define JSONSCANNER_H
+
+// Finds the next character of interest for the JSON tokenizer (quotes and
+// escapes in strings, the end of whitespace, the start of the document) in
+// blocks of 16 (SSE4.2) or 32 bytes (AVX2) rather than character by
+// character. The implementation is selected at runtime based on what the CPU
+// supports, with a portable scalar fallback.
+class JsonScanner {
+    public:
+        // Returns the first character in [begin, end) that is (not) one of
+        // the size characters in set, or end if there is none
+        static const char *findFirstOf(const char *begin, const char *end, const char *set, int size);
+        static const char *findFirstNotOf(const char *begin, const char *end, const char *set, int size);
+
+        // Name of the implementation in use, for the logs
+        static const char *getImplementation(void);
+
+    private:
+        typedef const char *(*ScanFunction)(const char *begin, const char *end, const char *set, int size, bool negate);
+
+        struct Implementation {
+            const char *name;
+            ScanFunction scan;
+        };
+
+        static const Implementation &getInstance(void);
+        static Implementation select(void);
+};
+
+#endif // JSONSCANNER_H
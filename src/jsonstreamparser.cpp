@@ -0,0 +1,392 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <cstring>
+
+#include "jsonstreamparser.h"
+#include "jsonscanner.h"
+
+// Maximum nesting depth, protects against malformed input
+static const int MAX_DEPTH = 256;
+
+// Insignificant whitespace between tokens
+static const char WHITESPACE[] = " \n\r\t";
+
+JsonStreamParser::JsonStreamParser(JsonHandler *handler) {
+    mHandler = handler;
+    reset();
+}
+
+void JsonStreamParser::reset(void) {
+    mState = STATE_PREAMBLE;
+    mStack.clear();
+    mBuffer.clear();
+    mOffset = 0;
+}
+
+bool JsonStreamParser::feed(const QByteArray &data) {
+    return feed(data.constData(), data.size());
+}
+
+// Parses as much as possible of the new data. If there is an incomplete token
+// left over from the last chunk, the new data has to be appended to it first,
+// otherwise the chunk is parsed in place.
+bool JsonStreamParser::feed(const char *data, int size) {
+    if(mState == STATE_DONE || mState == STATE_ERROR) {
+        return mState != STATE_ERROR;
+    }
+
+    if(mBuffer.isEmpty()) {
+        int consumed = parse(data, size, false);
+        if(consumed < size) {
+            mBuffer = QByteArray(data + consumed, size - consumed);
+        }
+    } else {
+        mBuffer.append(data, size);
+        int consumed = parse(mBuffer.constData(), mBuffer.size(), false);
+        mBuffer.remove(0, consumed);
+    }
+
+    return mState != STATE_ERROR;
+}
+
+bool JsonStreamParser::finish(void) {
+    if(!mBuffer.isEmpty() && mState != STATE_DONE && mState != STATE_ERROR) {
+        parse(mBuffer.constData(), mBuffer.size(), true);
+    }
+    mBuffer.clear();
+    return mState == STATE_DONE;
+}
+
+bool JsonStreamParser::isComplete(void) const {
+    return mState == STATE_DONE;
+}
+
+bool JsonStreamParser::hasError(void) const {
+    return mState == STATE_ERROR;
+}
+
+qint64 JsonStreamParser::getOffset(void) const {
+    return mOffset;
+}
+
+// Tokenizes the data; returns the number of bytes consumed. Parsing stops at
+// the first incomplete token unless this is the final chunk.
+int JsonStreamParser::parse(const char *data, int size, bool final) {
+    const char *position = data;
+    const char *end = data + size;
+
+    while(position < end && mState != STATE_DONE && mState != STATE_ERROR) {
+        char c = *position;
+
+        // Skip everything up to the start of the document
+        if(mState == STATE_PREAMBLE) {
+            position = JsonScanner::findFirstOf(position, end, "{[", 2);
+            if(position < end) {
+                mState = STATE_VALUE;
+            }
+            continue;
+        }
+
+        if(c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            position = JsonScanner::findFirstNotOf(position, end, WHITESPACE, 4);
+            continue;
+        }
+
+        const char *next = position;
+        switch(mState) {
+            case STATE_VALUE_OR_END:
+                if(c == ']') {
+                    next = position + 1;
+                    endContainer(']');
+                    break;
+                }
+                // Fall through
+
+            case STATE_VALUE:
+                next = parseValue(position, end, final);
+                break;
+
+            case STATE_KEY_OR_END:
+                if(c == '}') {
+                    next = position + 1;
+                    endContainer('}');
+                    break;
+                }
+                // Fall through
+
+            case STATE_KEY:
+                if(c == '"') {
+                    QString key;
+                    next = parseString(position, end, key);
+                    if(next != nullptr) {
+                        mHandler->key(key);
+                        mState = STATE_COLON;
+                    }
+                } else {
+                    setError();
+                }
+                break;
+
+            case STATE_COLON:
+                if(c == ':') {
+                    next = position + 1;
+                    mState = STATE_VALUE;
+                } else {
+                    setError();
+                }
+                break;
+
+            case STATE_COMMA_OR_END:
+                if(c == ',') {
+                    next = position + 1;
+                    mState = (mStack.last() == '{') ? STATE_KEY : STATE_VALUE;
+                } else if((c == '}' && mStack.last() == '{') || (c == ']' && mStack.last() == '[')) {
+                    next = position + 1;
+                    endContainer(c);
+                } else {
+                    setError();
+                }
+                break;
+
+            default:
+                setError();
+                break;
+        }
+
+        // Incomplete token, wait for more data
+        if(next == nullptr) {
+            if(final) {
+                setError();
+            }
+            break;
+        }
+        position = next;
+    }
+
+    // Once the document is complete, the rest (e.g. ');') is ignored
+    if(mState == STATE_DONE) {
+        position = end;
+    }
+
+    mOffset += position - data;
+    return position - data;
+}
+
+// Parses a single value; returns a pointer past the value, or nullptr if the
+// value is incomplete
+const char *JsonStreamParser::parseValue(const char *begin, const char *end, bool final) {
+    const char *next = begin;
+    switch(*begin) {
+        case '{':
+        case '[':
+            if(mStack.size() >= MAX_DEPTH) {
+                setError();
+                break;
+            }
+            mStack.append(*begin);
+            if(*begin == '{') {
+                mHandler->startObject();
+                mState = STATE_KEY_OR_END;
+            } else {
+                mHandler->startArray();
+                mState = STATE_VALUE_OR_END;
+            }
+            next = begin + 1;
+            break;
+
+        case '"': {
+                QString value;
+                next = parseString(begin, end, value);
+                if(next != nullptr) {
+                    mHandler->string(value);
+                    endValue();
+                }
+            }
+            break;
+
+        case 't':
+            next = parseLiteral(begin, end, "true", 4);
+            if(next != nullptr && mState != STATE_ERROR) {
+                mHandler->boolean(true);
+                endValue();
+            }
+            break;
+
+        case 'f':
+            next = parseLiteral(begin, end, "false", 5);
+            if(next != nullptr && mState != STATE_ERROR) {
+                mHandler->boolean(false);
+                endValue();
+            }
+            break;
+
+        case 'n':
+            next = parseLiteral(begin, end, "null", 4);
+            if(next != nullptr && mState != STATE_ERROR) {
+                mHandler->null();
+                endValue();
+            }
+            break;
+
+        default:
+            if(*begin == '-' || (*begin >= '0' && *begin <= '9')) {
+                next = parseNumber(begin, end, final);
+            } else {
+                setError();
+            }
+            break;
+    }
+
+    return next;
+}
+
+// Finds the end of the string starting at begin (which points to the opening
+// quote) and decodes it
+const char *JsonStreamParser::parseString(const char *begin, const char *end, QString &value) {
+    const char *position = begin + 1;
+    while(position < end) {
+        position = JsonScanner::findFirstOf(position, end, "\"\\", 2);
+        if(position == end) {
+            break;
+        } else if(*position == '"') {
+            value = decodeString(begin + 1, position);
+            return position + 1;
+        } else {
+            // Skip the escaped character
+            position += 2;
+        }
+    }
+    return nullptr;
+}
+
+// Numbers may continue in the next chunk, hence they are only complete once
+// a character that can't be part of a number follows
+const char *JsonStreamParser::parseNumber(const char *begin, const char *end, bool final) {
+    const char *position = begin;
+    bool integral = true;
+    while(position < end) {
+        char c = *position;
+        if(c == '.' || c == 'e' || c == 'E') {
+            integral = false;
+        } else if(!(c == '-' || c == '+' || (c >= '0' && c <= '9'))) {
+            break;
+        }
+        position++;
+    }
+    if(position == end && !final) {
+        return nullptr;
+    }
+
+    QByteArray text = QByteArray::fromRawData(begin, position - begin);
+    bool ok = false;
+    if(integral) {
+        qlonglong value = text.toLongLong(&ok);
+        if(ok) {
+            mHandler->integer(value);
+        }
+    }
+    if(!ok) {
+        double value = text.toDouble(&ok);
+        if(ok) {
+            mHandler->number(value);
+        }
+    }
+
+    if(ok) {
+        endValue();
+    } else {
+        setError();
+    }
+    return position;
+}
+
+const char *JsonStreamParser::parseLiteral(const char *begin, const char *end, const char *literal, int length) {
+    int available = qMin((int) (end - begin), length);
+    if(strncmp(begin, literal, available) != 0) {
+        setError();
+        return begin;
+    }
+    if(available < length) {
+        return nullptr;
+    }
+    return begin + length;
+}
+
+void JsonStreamParser::endContainer(char type) {
+    mStack.removeLast();
+    if(type == '}') {
+        mHandler->endObject();
+    } else {
+        mHandler->endArray();
+    }
+    endValue();
+}
+
+void JsonStreamParser::endValue(void) {
+    if(mStack.isEmpty()) {
+        mState = STATE_DONE;
+    } else {
+        mState = STATE_COMMA_OR_END;
+    }
+}
+
+void JsonStreamParser::setError(void) {
+    mState = STATE_ERROR;
+}
+
+// Decodes the escape sequences; the (common) case without any escapes is a
+// plain UTF-8 conversion
+QString JsonStreamParser::decodeString(const char *begin, const char *end) {
+    const char *escape = (const char *) memchr(begin, '\\', end - begin);
+    if(escape == nullptr) {
+        return QString::fromUtf8(begin, end - begin);
+    }
+
+    QString value;
+    const char *position = begin;
+    while(escape != nullptr) {
+        value.append(QString::fromUtf8(position, escape - position));
+        position = escape + 2;
+        switch(escape[1]) {
+            case 'b': value.append(QChar('\b')); break;
+            case 'f': value.append(QChar('\f')); break;
+            case 'n': value.append(QChar('\n')); break;
+            case 'r': value.append(QChar('\r')); break;
+            case 't': value.append(QChar('\t')); break;
+            case 'u':
+                // Surrogate pairs are simply two consecutive UTF-16 units
+                if(end - position >= 4) {
+                    bool ok = false;
+                    ushort unit = QByteArray::fromRawData(position, 4).toUShort(&ok, 16);
+                    value.append(QChar(ok ? unit : QChar::ReplacementCharacter));
+                    position += 4;
+                }
+                break;
+            default:
+                // \" \\ \/
+                value.append(QChar(escape[1]));
+                break;
+        }
+        escape = (const char *) memchr(position, '\\', end - position);
+    }
+    value.append(QString::fromUtf8(position, end - position));
+
+    return value;
+}
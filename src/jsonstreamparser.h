@@ -0,0 +1,101 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef JSONSTREAMPARSER_H
+#define JSONSTREAMPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Receives the tokens of a JSON document from the JsonStreamParser
+class JsonHandler {
+    public:
+        virtual ~JsonHandler() {}
+
+        virtual void startObject(void) = 0;
+        virtual void endObject(void) = 0;
+        virtual void startArray(void) = 0;
+        virtual void endArray(void) = 0;
+        virtual void key(const QString &key) = 0;
+        virtual void string(const QString &value) = 0;
+        virtual void integer(qlonglong value) = 0;
+        virtual void number(double value) = 0;
+        virtual void boolean(bool value) = 0;
+        virtual void null(void) = 0;
+};
+
+// Incremental (push) JSON tokenizer: The data can be fed in arbitrary chunks as
+// it arrives from the network; complete tokens are passed to the handler right
+// away and only an incomplete token at the end of a chunk is kept until the
+// next chunk arrives.
+//
+// Anything before the first '{' or '[' and after the end of the top-level
+// value is ignored, which takes care of JSONP callback wrappers such as
+// 'externalStatisticsCallback(...);'.
+class JsonStreamParser {
+    private:
+        enum PARSER_STATE {
+            STATE_PREAMBLE = 0,
+            STATE_VALUE,
+            STATE_VALUE_OR_END,
+            STATE_KEY,
+            STATE_KEY_OR_END,
+            STATE_COLON,
+            STATE_COMMA_OR_END,
+            STATE_DONE,
+            STATE_ERROR
+        };
+
+        JsonHandler *mHandler;
+        int mState;
+        QVector<char> mStack;
+        QByteArray mBuffer;
+        qint64 mOffset;
+
+        int parse(const char *data, int size, bool final);
+        const char *parseValue(const char *begin, const char *end, bool final);
+        const char *parseString(const char *begin, const char *end, QString &value);
+        const char *parseNumber(const char *begin, const char *end, bool final);
+        const char *parseLiteral(const char *begin, const char *end, const char *literal, int length);
+        void endContainer(char type);
+        void endValue(void);
+        void setError(void);
+
+        static QString decodeString(const char *begin, const char *end);
+
+    public:
+        explicit JsonStreamParser(JsonHandler *handler);
+
+        void reset(void);
+        bool feed(const char *data, int size);
+        bool feed(const QByteArray &data);
+
+        // To be called after the last chunk; returns true if a complete
+        // document was parsed
+        bool finish(void);
+
+        bool isComplete(void) const;
+        bool hasError(void) const;
+
+        // Number of bytes consumed so far (including skipped ones)
+        qint64 getOffset(void) const;
+};
+
+#endif // JSONSTREAMPARSER_H
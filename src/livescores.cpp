@@ -90,14 +90,12 @@ LiveScores::LiveScores(QObject *parent) : QObject(parent) {
     // TODO: Split "update" into "updateSummaries" and "updateGame"?
     mDataSource->update(mSelectedGameId);
 
-    // Create a timer that periodically fires to update the data, defaults to 5 mins
-    Config& config = Config::getInstance();
-    int updateInterval = config.getValue("updateInterval", 0.5).toInt();
-    mUpdateTimer = new QTimer(this);
-    mUpdateTimer->setTimerType(Qt::PreciseTimer);
-    mUpdateTimer->setSingleShot(false);
-    connect(mUpdateTimer, SIGNAL(timeout()), this, SLOT(updateData()));
-    mUpdateTimer->start(updateInterval*60*1000);
+    // Schedule the next update whenever an update is finished; the interval
+    // depends on the status of the games (in play, intermission, etc.)
+    mUpdateScheduler = new UpdateScheduler(mGamesList, this);
+    connect(mUpdateScheduler, SIGNAL(updateRequested()), this, SLOT(updateData()));
+    connect(mDataSource, SIGNAL(updateFinished()), mUpdateScheduler, SLOT(reschedule()));
+    mUpdateScheduler->start();
 
 #if 0
     // TODO: Use this code to show the info banner from C++ (Harmattan).
@@ -125,7 +123,7 @@ void LiveScores::updateView(QString id) {
     Game *game = mGamesList->getGame(id);
     if(game != NULL) {
         // Force a details update for the specified game
-        mDataSource->getGameDetails(id);
+        mDataSource->getGameDetails(id, true);
 
         // Set the details data models
         QQmlContext *context = mQmlViewer->rootContext();
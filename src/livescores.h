@@ -22,7 +22,6 @@
 
 #include <QObject>
 #include <QString>
-#include <QTimer>
 #include <QEvent>
 #include <QSortFilterProxyModel>
 #include <QQuickView>
@@ -31,6 +30,7 @@
 #include "sihfdatasource.h"
 #include "gamelist.h"
 #include "notifier.h"
+#include "updatescheduler.h"
 
 class LiveScores : public QObject {
     Q_OBJECT
@@ -45,7 +45,7 @@ class LiveScores : public QObject {
         GameList *mGamesList;
         QSortFilterProxyModel *mLeagueFilter;
         SIHFDataSource *mDataSource;
-        QTimer *mUpdateTimer;
+        UpdateScheduler *mUpdateScheduler;
         QString mSelectedGameId;
         QList<QObject *> mLeaguesList;
 
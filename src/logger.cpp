@@ -57,6 +57,10 @@ void Logger::setLevel(int level) {
     this->loglevel = level;
 }
 
+int Logger::getLevel(void) const {
+    return this->loglevel;
+}
+
 void Logger::log(int level, QString message) {
     // Check if the message is of a type below the current log level and that
     // the logfile is writable
@@ -75,7 +79,9 @@ void Logger::dump(QString filename, QString data) {
         QDir datapath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
         QFile dumpfile(datapath.canonicalPath() + '/' + filename);
 
-        if(dumpfile.open(QIODevice::Append)) {
+        // Every dump holds a single response; a later one with the same name
+        // replaces it
+        if(dumpfile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
             QTextStream *stream = new QTextStream(&dumpfile);
             *(stream) << data << endl;
             stream->flush();
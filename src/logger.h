@@ -48,6 +48,7 @@ class Logger {
         void setLogfile(QString);
         void close();
         void setLevel(int);
+        int getLevel(void) const;
         void log(int, QString);
         void dump(QString, QString);
 
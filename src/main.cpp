@@ -25,6 +25,7 @@
 #include <QGuiApplication>
 #include <sailfishapp.h>
 #include <QStandardPaths>
+#include <QDateTime>
 #include <QDir>
 
 // Qt Modules
@@ -58,6 +59,10 @@ int main(int argc, char *argv[]) {
     //logger.setLevel(Logger::DEBUG);
     logger.setLevel(Logger::ERROR);
 
+    // Seed the random number generator once (used e.g. for the jitter of the
+    // request retries)
+    qsrand((uint) QDateTime::currentMSecsSinceEpoch());
+
     // Create a controller that generates the UI and connects all the necessary
     // signals, etc.
     LiveScores *livescores = new LiveScores();
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "parsearena.h"
+
+const size_t ParseArena::DEFAULT_BLOCK_SIZE;
+
+ParseArena::ParseArena(size_t blockSize) : mBlockSize(blockSize), mUsed(0), mHighWater(0) {
+}
+
+ParseArena::~ParseArena() {
+    release();
+    if(!mBlocks.isEmpty()) {
+        delete[] mBlocks.first().data;
+    }
+}
+
+// Takes the memory from the current block, or starts a new one if it doesn't
+// fit anymore. Objects larger than a block get a block of their own.
+void *ParseArena::allocate(size_t size, size_t alignment) {
+    if(!mBlocks.isEmpty()) {
+        Block &block = mBlocks.last();
+        size_t offset = (block.used + alignment - 1) & ~(alignment - 1);
+        if(offset + size <= block.size) {
+            mUsed += offset + size - block.used;
+            block.used = offset + size;
+            mHighWater = qMax(mHighWater, mUsed);
+            return block.data + offset;
+        }
+    }
+
+    Block block;
+    block.size = qMax(mBlockSize, size);
+    block.data = new char[block.size];
+    block.used = size;
+    mBlocks.append(block);
+    mUsed += size;
+    mHighWater = qMax(mHighWater, mUsed);
+    return block.data;
+}
+
+void ParseArena::release(void) {
+    // Objects are destroyed in the reverse order of their creation
+    for(int i = mDestructors.size() - 1; i >= 0; i--) {
+        mDestructors.at(i).destroy(mDestructors.at(i).object);
+    }
+    mDestructors.clear();
+
+    while(mBlocks.size() > 1) {
+        delete[] mBlocks.last().data;
+        mBlocks.removeLast();
+    }
+    if(!mBlocks.isEmpty()) {
+        mBlocks.first().used = 0;
+    }
+    mUsed = 0;
+}
+
+size_t ParseArena::getUsed(void) const {
+    return mUsed;
+}
+
+size_t ParseArena::getReserved(void) const {
+    size_t reserved = 0;
+    for(int i = 0; i < mBlocks.size(); i++) {
+        reserved += mBlocks.at(i).size;
+    }
+    return reserved;
+}
+
+size_t ParseArena::getHighWater(void) const {
+    return mHighWater;
+}
+
+int ParseArena::getBlockCount(void) const {
+    return mBlocks.size();
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef PARSEARENA_H
+#define PARSEARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include <QVector>
+#include <QtGlobal>
+
+// Monotonic allocator for the records decoded from a single response. The
+// objects are placed one after the other in large blocks and are all
+// destroyed together when the arena is released (or destroyed), instead of
+// each of them being allocated and freed on its own. The first block is kept
+// when the arena is released, so that it can be reused for the next response
+// (the details decoders are recycled together with their arenas). Note that
+// members such as QString or QVector still allocate their data on their own.
+class ParseArena {
+    private:
+        struct Block {
+            char *data;
+            size_t size;
+            size_t used;
+        };
+
+        // Objects that need their destructor called on release
+        struct Destructor {
+            void (*destroy)(void *object);
+            void *object;
+        };
+
+        QVector<Block> mBlocks;
+        QVector<Destructor> mDestructors;
+        size_t mBlockSize;
+
+        // Statistics: bytes handed out and the maximum thereof
+        size_t mUsed;
+        size_t mHighWater;
+
+        void *allocate(size_t size, size_t alignment);
+
+        template<class T>
+        static void destroy(void *object) {
+            static_cast<T *>(object)->~T();
+        }
+
+        Q_DISABLE_COPY(ParseArena)
+
+    public:
+        static const size_t DEFAULT_BLOCK_SIZE = 16*1024;
+
+        explicit ParseArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+        ~ParseArena();
+
+        // Creates a value-initialized object that lives until the arena is
+        // released
+        template<class T>
+        T *create(void) {
+            T *object = new(allocate(sizeof(T), alignof(T))) T();
+            if(!std::is_trivially_destructible<T>::value) {
+                Destructor destructor;
+                destructor.destroy = &ParseArena::destroy<T>;
+                destructor.object = object;
+                mDestructors.append(destructor);
+            }
+            return object;
+        }
+
+        // Destroys all the objects at once
+        void release(void);
+
+        size_t getUsed(void) const;
+        size_t getReserved(void) const;
+        size_t getHighWater(void) const;
+        int getBlockCount(void) const;
+};
+
+#endif // PARSEARENA_H
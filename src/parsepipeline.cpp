@@ -0,0 +1,91 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "parsepipeline.h"
+#include "jsonscanner.h"
+#include "logger.h"
+
+ParsePipeline::ParsePipeline(QObject *parent) : QObject(parent) {
+    mThread.start();
+
+    // Report which scanner the parser thread will use (SIMD or scalar)
+    Logger& logger = Logger::getInstance();
+    logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": JSON scanner implementation: " + QString(JsonScanner::getImplementation()) + "."));
+}
+
+ParsePipeline::~ParsePipeline() {
+    // Decoders that are still in flight are deleted by the parser thread when
+    // it quits
+    QHashIterator<QObject *, JsonDecoder *> iDecoder(mDecoders);
+    while(iDecoder.hasNext()) {
+        iDecoder.next().value()->deleteLater();
+    }
+    mThread.quit();
+    mThread.wait();
+
+    JsonDecoder *decoder;
+    while(mResults.pop(decoder)) {
+        delete decoder;
+    }
+}
+
+void ParsePipeline::attach(ReplyDecoder *source, JsonDecoder *decoder) {
+    decoder->moveToThread(&mThread);
+    mDecoders.insert(source, decoder);
+
+    // The chunks are queued to the parser thread in the order they arrive
+    connect(source, SIGNAL(dataDecoded(QByteArray)), decoder, SLOT(feed(QByteArray)));
+    connect(decoder, SIGNAL(completed(JsonDecoder*)), this, SLOT(publish(JsonDecoder*)), Qt::DirectConnection);
+    connect(source, SIGNAL(destroyed(QObject*)), this, SLOT(discard(QObject*)));
+}
+
+bool ParsePipeline::finish(ReplyDecoder *source) {
+    JsonDecoder *decoder = mDecoders.take(source);
+    if(decoder == nullptr) {
+        return false;
+    }
+
+    // Queued behind the chunks that are still pending
+    disconnect(source, 0, decoder, 0);
+    QMetaObject::invokeMethod(decoder, "complete", Qt::QueuedConnection);
+    return true;
+}
+
+// Called on the parser thread once a decoder has completed
+void ParsePipeline::publish(JsonDecoder *decoder) {
+    decoder->moveToThread(thread());
+    while(!mResults.push(decoder)) {
+        QThread::yieldCurrentThread();
+    }
+    QMetaObject::invokeMethod(this, "processResults", Qt::QueuedConnection);
+}
+
+void ParsePipeline::processResults(void) {
+    JsonDecoder *decoder;
+    while(mResults.pop(decoder)) {
+        emit parsed(decoder);
+    }
+}
+
+void ParsePipeline::discard(QObject *source) {
+    JsonDecoder *decoder = mDecoders.take(source);
+    if(decoder != nullptr) {
+        decoder->deleteLater();
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef PARSEPIPELINE_H
+#define PARSEPIPELINE_H
+
+#include <QObject>
+#include <QHash>
+#include <QThread>
+
+#include "jsondecoder.h"
+#include "replydecoder.h"
+#include "spscqueue.h"
+
+// Runs the JSON decoders off the GUI thread. The decoders are attached to a
+// reply while it's being downloaded and are fed the decoded chunks on the
+// parser thread. Once a reply is complete, its decoder is finished on the
+// parser thread as well and handed back to the GUI thread through a
+// single-producer/single-consumer queue; the decoder and the records it holds
+// aren't modified anymore after that, so the models can be updated from them
+// without any locking.
+//
+// Applying the records (creating and updating the games, players and events)
+// deliberately stays on the GUI thread: these are QObjects and models owned by
+// it. The decoders do all the text parsing up front (times, scores, goalkeeper
+// changes), so that what's left there are hash lookups and model updates.
+class ParsePipeline : public QObject {
+    Q_OBJECT
+
+    private:
+        static const int QUEUE_SIZE = 64;
+
+        QThread mThread;
+
+        // Decoders by the reply decoder feeding them; only used on the GUI
+        // thread
+        QHash<QObject *, JsonDecoder *> mDecoders;
+
+        // Finished decoders, from the parser thread to the GUI thread
+        SpscQueue<JsonDecoder *, QUEUE_SIZE> mResults;
+
+    public:
+        explicit ParsePipeline(QObject *parent = 0);
+        ~ParsePipeline();
+
+        // Takes ownership of the decoder (which must not have a parent) and
+        // feeds it the data of the reply
+        void attach(ReplyDecoder *source, JsonDecoder *decoder);
+
+        // Finishes decoding the reply after the last chunk; the decoder is
+        // handed back through parsed(). Returns false if no decoder was
+        // attached. Decoders of replies that are deleted without being
+        // finished are discarded.
+        bool finish(ReplyDecoder *source);
+
+    signals:
+        // The receiver takes ownership of the decoder
+        void parsed(JsonDecoder *decoder);
+
+    private slots:
+        void publish(JsonDecoder *decoder);
+        void processResults(void);
+        void discard(QObject *source);
+};
+
+#endif // PARSEPIPELINE_H
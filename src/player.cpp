@@ -22,6 +22,8 @@
 
 Player::Player(qulonglong teamId, quint32 id, QObject *parent) : QObject(parent), mTeamId(teamId), mPlayerId(id) {
     mPosition = POSITION_UNDEFINED;
+    mJerseyNumber = 0;
+    mLineNumber = 0;
     for(int iStat = 0; iStat < STATS_LEN; iStat++) {
         mStats.append("0");
     }
@@ -44,6 +44,11 @@ class Player : public QObject {
         // List of human-readable position strings
         static QList<QString> PositionStrings;
 
+        // The jersey number is indexed by the PlayerList, so it may only be
+        // changed through PlayerList::setJerseyNumber()
+        void setJerseyNumber(quint8 jerseyNumber);
+        friend class PlayerList;
+
     public:
         enum PLAYER_POSITION : quint8 {
             POSITION_UNDEFINED = 0,
@@ -83,7 +88,6 @@ class Player : public QObject {
         void setName(QString firstName, QString lastName);
         QString getName() const;
 
-        void setJerseyNumber(quint8 jerseyNumber);
         quint8 getJerseyNumber() const;
 
         void setLineNumber(quint8 lineNumber);
@@ -26,26 +26,65 @@ PlayerList::PlayerList(QObject *parent) : QAbstractListModel(parent) {
 }
 
 Player *PlayerList::getPlayer(quint32 playerId) {
-    Player *player = nullptr;
-    bool found = false;
-    QVectorIterator<Player *> iterator(mPlayers);
-    while(!found && iterator.hasNext()) {
-        Player *candidate = iterator.next();
-        if(candidate->getPlayerId() == playerId) {
-            player = candidate;
-            found = true;
-        }
-    }
-    return player;
+    return mPlayersById.value(playerId, nullptr);
 }
 
 Player *PlayerList::getPlayerByJerseyNumber(quint8 jerseyNumber){
-#if 0
-    quint32 playerId = mJerseyNumbers.value(jerseyNumber);
-    return mPlayers.value(playerId, nullptr);
-#endif
-    // TODO: Re-implement this.
-    return nullptr;
+    return mPlayersByJerseyNumber.value(jerseyNumber, nullptr);
+}
+
+void PlayerList::setJerseyNumber(Player *player, quint8 jerseyNumber) {
+    if(player->getJerseyNumber() == jerseyNumber) {
+        return;
+    }
+
+    bool listed = (mPlayersById.value(player->getPlayerId(), nullptr) == player);
+    if(listed) {
+        unindexJerseyNumber(player);
+    }
+    player->setJerseyNumber(jerseyNumber);
+    if(listed) {
+        indexJerseyNumber(player);
+    }
+}
+
+// Adds a player to the jersey number index. Collisions (e.g. during a roster
+// update in the middle of a game) are logged and the player already indexed is
+// kept.
+void PlayerList::indexJerseyNumber(Player *player) {
+    quint8 jerseyNumber = player->getJerseyNumber();
+    if(jerseyNumber == 0) {
+        return;
+    }
+
+    Player *holder = mPlayersByJerseyNumber.value(jerseyNumber, nullptr);
+    if(holder == nullptr) {
+        mPlayersByJerseyNumber.insert(jerseyNumber, player);
+    } else if(holder != player) {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::WARN, QString(Q_FUNC_INFO).append(": Jersey number " + QString::number(jerseyNumber) + " is used by players "
+            + QString::number(holder->getPlayerId()) + " and " + QString::number(player->getPlayerId()) + ", keeping player "
+            + QString::number(holder->getPlayerId()) + "."));
+    }
+}
+
+// Removes a player from the jersey number index; if another player of the list
+// has the same number, that one takes its place
+void PlayerList::unindexJerseyNumber(Player *player) {
+    quint8 jerseyNumber = player->getJerseyNumber();
+    if(jerseyNumber == 0 || mPlayersByJerseyNumber.value(jerseyNumber, nullptr) != player) {
+        return;
+    }
+
+    mPlayersByJerseyNumber.remove(jerseyNumber);
+    QVectorIterator<Player *> iPlayer(mPlayers);
+    while(iPlayer.hasNext()) {
+        Player *other = iPlayer.next();
+        if(other != player && other->getJerseyNumber() == jerseyNumber) {
+            mPlayersByJerseyNumber.insert(jerseyNumber, other);
+            break;
+        }
+    }
 }
 
 int PlayerList::rowCount(const QModelIndex &parent) const {
@@ -71,19 +110,25 @@ QVariant PlayerList::data(const QModelIndex &index, int /* role */) const {
 }
 
 void PlayerList::insert(Player *player) {
-    if(!mPlayers.contains(player)) {
-        beginInsertRows(QModelIndex(), 0, 0);
+    if(!mPlayersById.contains(player->getPlayerId())) {
+        beginInsertRows(QModelIndex(), mPlayers.size(), mPlayers.size());
         mPlayers.append(player);
+        mPlayersById.insert(player->getPlayerId(), player);
+        indexJerseyNumber(player);
         endInsertRows();
     }
 }
 
 void PlayerList::remove(Player *player) {
-    beginRemoveRows(QModelIndex(), 0, 0);
-#if 0
-    quint32 playerId = player->getPlayerId();
-    mPlayers.remove(playerId);
-#endif
+    int row = mPlayers.indexOf(player);
+    if(row < 0) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    mPlayers.remove(row);
+    mPlayersById.remove(player->getPlayerId());
+    unindexJerseyNumber(player);
     endRemoveRows();
 }
 
@@ -102,6 +147,8 @@ void PlayerList::sort(int column, Qt::SortOrder order) {
 void PlayerList::clear(void) {
     beginResetModel();
     mPlayers.clear();
+    mPlayersById.clear();
+    mPlayersByJerseyNumber.clear();
     endResetModel();
 }
 
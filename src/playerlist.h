@@ -21,6 +21,7 @@
 #define PLAYERLIST_H
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QMap>
 #include <QVector>
 
@@ -32,6 +33,15 @@ class PlayerList : public QAbstractListModel {
     private:
         QVector<Player *> mPlayers;
 
+        // Indexes into mPlayers by licence number and jersey number; players
+        // without a jersey number (0) aren't indexed by it. If two players
+        // share a jersey number, the one that had it first is kept.
+        QHash<quint32, Player *> mPlayersById;
+        QHash<quint8, Player *> mPlayersByJerseyNumber;
+
+        void indexJerseyNumber(Player *player);
+        void unindexJerseyNumber(Player *player);
+
     protected:
         QHash<int, QByteArray> roleNames() const override;
 
@@ -42,6 +52,9 @@ class PlayerList : public QAbstractListModel {
         Player *getPlayer(quint32 playerId);
         Player *getPlayerByJerseyNumber(quint8 jerseyNumber);
 
+        // Updates the jersey number of a player in the list (and the index)
+        void setJerseyNumber(Player *player, quint8 jerseyNumber);
+
         // ListModel functionality
         int rowCount(const QModelIndex &parent = QModelIndex()) const override;
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <zlib.h>
+#ifdef HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+
+#include "replydecoder.h"
+#include "logger.h"
+
+// Size of the intermediate output buffer
+static const int BUFFER_SIZE = 16384;
+
+ReplyDecoder::ReplyDecoder(QNetworkReply *reply) : QObject(reply), mHash(QCryptographicHash::Md5) {
+    mReply = reply;
+    mEncoding = ENCODING_IDENTITY;
+    mInitialized = false;
+    mError = false;
+    mRawDeflate = false;
+    mZStream = nullptr;
+    mBrotliState = nullptr;
+    mWireBytes = 0;
+    mDecodedBytes = 0;
+    mBuffering = true;
+
+    // Decode the data as it arrives rather than all at once at the end
+    connect(mReply, SIGNAL(readyRead()), this, SLOT(readData()));
+}
+
+ReplyDecoder::~ReplyDecoder(void) {
+    if(mZStream != nullptr) {
+        inflateEnd(mZStream);
+        delete mZStream;
+    }
+#ifdef HAVE_BROTLI
+    if(mBrotliState != nullptr) {
+        BrotliDecoderDestroyInstance(mBrotliState);
+    }
+#endif
+}
+
+// The header is only available once the first data arrives, hence we set up
+// the decompressor lazily.
+void ReplyDecoder::initialize(void) {
+    QByteArray contentEncoding = mReply->rawHeader("Content-Encoding").trimmed().toLower();
+    if(contentEncoding.isEmpty() || contentEncoding == "identity") {
+        mEncoding = ENCODING_IDENTITY;
+    } else if(contentEncoding == "gzip" || contentEncoding == "x-gzip") {
+        mEncoding = ENCODING_GZIP;
+    } else if(contentEncoding == "deflate") {
+        mEncoding = ENCODING_DEFLATE;
+#ifdef HAVE_BROTLI
+    } else if(contentEncoding == "br") {
+        mEncoding = ENCODING_BROTLI;
+#endif
+    } else {
+        mEncoding = ENCODING_UNSUPPORTED;
+    }
+
+    if(mEncoding == ENCODING_GZIP || mEncoding == ENCODING_DEFLATE) {
+        // Let zlib detect the gzip or zlib header by itself (32 + window bits)
+        mZStream = new z_stream;
+        mZStream->zalloc = Z_NULL;
+        mZStream->zfree = Z_NULL;
+        mZStream->opaque = Z_NULL;
+        mZStream->next_in = Z_NULL;
+        mZStream->avail_in = 0;
+        if(inflateInit2(mZStream, 32 + MAX_WBITS) != Z_OK) {
+            mError = true;
+        }
+#ifdef HAVE_BROTLI
+    } else if(mEncoding == ENCODING_BROTLI) {
+        mBrotliState = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+        if(mBrotliState == nullptr) {
+            mError = true;
+        }
+#endif
+    } else if(mEncoding == ENCODING_UNSUPPORTED) {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Unsupported content encoding '" + contentEncoding + "'."));
+        mError = true;
+    }
+
+    mInitialized = true;
+}
+
+// Reads what is available from the reply and decodes it
+void ReplyDecoder::readData(void) {
+    if(!mInitialized) {
+        initialize();
+    }
+
+    QByteArray chunk = mReply->readAll();
+    mWireBytes += chunk.size();
+    if(chunk.isEmpty() || mError) {
+        return;
+    }
+
+    QByteArray decoded;
+    switch(mEncoding) {
+        case ENCODING_GZIP:
+        case ENCODING_DEFLATE:
+            decoded = inflateChunk(chunk);
+            break;
+
+        case ENCODING_BROTLI:
+            decoded = brotliChunk(chunk);
+            break;
+
+        default:
+            decoded = chunk;
+            break;
+    }
+    if(decoded.isEmpty()) {
+        return;
+    }
+
+    // Pass the data on to the parser right away; the body is only kept if
+    // somebody wants it as a whole
+    mDecodedBytes += decoded.size();
+    mHash.addData(decoded);
+    if(mBuffering) {
+        mData.append(decoded);
+    }
+    emit dataDecoded(decoded);
+}
+
+QByteArray ReplyDecoder::inflateChunk(const QByteArray &chunk) {
+    QByteArray decoded;
+    char buffer[BUFFER_SIZE];
+    mZStream->next_in = (Bytef *) chunk.constData();
+    mZStream->avail_in = chunk.size();
+
+    int status = Z_OK;
+    do {
+        mZStream->next_out = (Bytef *) buffer;
+        mZStream->avail_out = BUFFER_SIZE;
+        status = inflate(mZStream, Z_NO_FLUSH);
+
+        // Some servers send raw deflate data without the zlib header; retry
+        // in raw mode if the very first bytes can't be decoded.
+        if(status == Z_DATA_ERROR && mEncoding == ENCODING_DEFLATE && !mRawDeflate && mZStream->total_out == 0) {
+            mRawDeflate = true;
+            if(inflateReset2(mZStream, -MAX_WBITS) != Z_OK) {
+                mError = true;
+                break;
+            }
+            mZStream->next_in = (Bytef *) chunk.constData();
+            mZStream->avail_in = chunk.size();
+            continue;
+        }
+
+        if(status == Z_NEED_DICT || status == Z_DATA_ERROR || status == Z_MEM_ERROR || status == Z_STREAM_ERROR) {
+            Logger& logger = Logger::getInstance();
+            logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Failed to inflate the response data."));
+            mError = true;
+            break;
+        }
+        decoded.append(buffer, BUFFER_SIZE - mZStream->avail_out);
+    } while(status != Z_STREAM_END && (mZStream->avail_in > 0 || mZStream->avail_out == 0));
+
+    return decoded;
+}
+
+QByteArray ReplyDecoder::brotliChunk(const QByteArray &chunk) {
+    QByteArray decoded;
+#ifdef HAVE_BROTLI
+    uint8_t buffer[BUFFER_SIZE];
+    size_t availableIn = chunk.size();
+    const uint8_t *nextIn = (const uint8_t *) chunk.constData();
+
+    BrotliDecoderResult result;
+    do {
+        size_t availableOut = BUFFER_SIZE;
+        uint8_t *nextOut = buffer;
+        result = BrotliDecoderDecompressStream(mBrotliState, &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+        if(result == BROTLI_DECODER_RESULT_ERROR) {
+            Logger& logger = Logger::getInstance();
+            logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Failed to decode the brotli response data."));
+            mError = true;
+            break;
+        }
+        decoded.append((const char *) buffer, BUFFER_SIZE - availableOut);
+    } while(result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT);
+#else
+    Q_UNUSED(chunk);
+    mError = true;
+#endif
+
+    return decoded;
+}
+
+QByteArray ReplyDecoder::readAll(void) {
+    readData();
+    return mData;
+}
+
+void ReplyDecoder::setBuffering(bool buffering) {
+    mBuffering = buffering;
+}
+
+QByteArray ReplyDecoder::getContentHash(void) const {
+    return mHash.result();
+}
+
+bool ReplyDecoder::hasError(void) const {
+    return mError;
+}
+
+int ReplyDecoder::getEncoding(void) const {
+    return mEncoding;
+}
+
+qint64 ReplyDecoder::getWireBytes(void) const {
+    return mWireBytes;
+}
+
+qint64 ReplyDecoder::getDecodedBytes(void) const {
+    return mDecodedBytes;
+}
+
+QByteArray ReplyDecoder::acceptEncoding(void) {
+#ifdef HAVE_BROTLI
+    return QByteArray("br, gzip, deflate");
+#else
+    return QByteArray("gzip, deflate");
+#endif
+}
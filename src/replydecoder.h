@@ -0,0 +1,97 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef REPLYDECODER_H
+#define REPLYDECODER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QtNetwork/QNetworkReply>
+
+// Opaque decompressor states, see zlib.h and brotli/decode.h
+struct z_stream_s;
+struct BrotliDecoderStateStruct;
+
+// Reads the body of a network reply as it arrives and undoes the content
+// encoding (gzip, deflate, and brotli where available) on the fly. The decoded
+// data is passed on through dataDecoded() as it arrives. The decoder is a child
+// of the reply and is hence deleted together with the reply.
+class ReplyDecoder : public QObject {
+    Q_OBJECT
+
+    public:
+        enum CONTENT_ENCODING {
+            ENCODING_IDENTITY = 0,
+            ENCODING_GZIP,
+            ENCODING_DEFLATE,
+            ENCODING_BROTLI,
+            ENCODING_UNSUPPORTED
+        };
+
+    private:
+        QNetworkReply *mReply;
+        int mEncoding;
+        bool mInitialized;
+        bool mError;
+        bool mRawDeflate;
+
+        // Decompressor states
+        struct z_stream_s *mZStream;
+        struct BrotliDecoderStateStruct *mBrotliState;
+
+        // Decoded body and statistics
+        bool mBuffering;
+        QByteArray mData;
+        QCryptographicHash mHash;
+        qint64 mWireBytes;
+        qint64 mDecodedBytes;
+
+        void initialize(void);
+        QByteArray inflateChunk(const QByteArray &chunk);
+        QByteArray brotliChunk(const QByteArray &chunk);
+
+    public:
+        explicit ReplyDecoder(QNetworkReply *reply);
+        ~ReplyDecoder(void);
+
+        // Reads any data that is still pending and returns the decoded body
+        // (empty if buffering is disabled)
+        QByteArray readAll(void);
+        void setBuffering(bool buffering);
+
+        // MD5 hash of the decoded body
+        QByteArray getContentHash(void) const;
+
+        bool hasError(void) const;
+        int getEncoding(void) const;
+        qint64 getWireBytes(void) const;
+        qint64 getDecodedBytes(void) const;
+
+        // Value for the Accept-Encoding header
+        static QByteArray acceptEncoding(void);
+
+    signals:
+        void dataDecoded(const QByteArray &data);
+
+    public slots:
+        void readData(void);
+};
+
+#endif // REPLYDECODER_H
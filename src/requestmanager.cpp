@@ -0,0 +1,381 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <QTimer>
+
+#include "requestmanager.h"
+#include "replydecoder.h"
+#include "config.h"
+#include "logger.h"
+
+RequestManager::RequestManager(QNetworkAccessManager *networkManager, int maxConcurrentRequests, QObject *parent) : QObject(parent) {
+    mNetworkManager = networkManager;
+    mMaxConcurrentRequests = qMax(1, maxConcurrentRequests);
+    mFreshnessWindow = 0;
+
+    // Retry and circuit breaker settings; delays are in ms
+    Config& config = Config::getInstance();
+    mMaxRetries = config.getValue("maxRetries", 3).toInt();
+    mRetryDelay = config.getValue("retryDelay", 1000).toInt();
+    mMaxRetryDelay = config.getValue("maxRetryDelay", 30000).toInt();
+    mFailureThreshold = config.getValue("circuitBreakerThreshold", 5).toInt();
+    mCooldown = config.getValue("circuitBreakerCooldown", 30000).toInt();
+    mCurrentCooldown = mCooldown;
+    mConsecutiveFailures = 0;
+    mCircuitState = CIRCUIT_CLOSED;
+
+    // Deadline of a single request and the hedging delay used until enough
+    // latencies have been observed, in ms
+    mTimeout = config.getValue("requestTimeout", 15000).toInt();
+    mDefaultHedgeDelay = config.getValue("hedgeDelay", 2000).toInt();
+}
+
+// Queues a request and sends it right away if the limit permits
+bool RequestManager::get(QString key, QNetworkRequest request, bool hedged) {
+    updateCircuitState();
+
+    Logger& logger = Logger::getInstance();
+    if(isPending(key)) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Request '" + key + "' already pending, coalesced."));
+        return false;
+    }
+    if(isFresh(key)) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Response for '" + key + "' is still fresh, not requested again."));
+        return false;
+    }
+    if(getCircuitState() == CIRCUIT_OPEN) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Circuit breaker open, request '" + key + "' rejected."));
+        return false;
+    }
+
+    PendingRequest pending;
+    pending.key = key;
+    pending.request = request;
+    pending.attempt = 0;
+    pending.hedged = hedged;
+    mQueue.append(pending);
+    mPendingKeys.insert(key);
+    sendNext();
+
+    return true;
+}
+
+bool RequestManager::isPending(QString key) const {
+    return mPendingKeys.contains(key);
+}
+
+bool RequestManager::isFresh(QString key) const {
+    QHash<QString, QElapsedTimer>::const_iterator completed = mCompleted.constFind(key);
+    return mFreshnessWindow > 0 && completed != mCompleted.constEnd() && !completed->hasExpired(mFreshnessWindow);
+}
+
+void RequestManager::invalidate(QString key) {
+    mCompleted.remove(key);
+}
+
+// Sends queued requests until the concurrency limit is reached. While the
+// circuit breaker is half-open, only a single probe request is sent.
+void RequestManager::sendNext(void) {
+    int maxConcurrentRequests = mMaxConcurrentRequests;
+    if(getCircuitState() == CIRCUIT_HALF_OPEN) {
+        maxConcurrentRequests = 1;
+    }
+
+    while(!mQueue.isEmpty() && mActiveRequests.size() < maxConcurrentRequests) {
+        PendingRequest pending = mQueue.takeFirst();
+        QNetworkReply *reply = send(pending);
+
+        // Send a second request if this one takes unusually long
+        if(pending.hedged && getCircuitState() == CIRCUIT_CLOSED) {
+            QTimer *hedgeTimer = new QTimer(reply);
+            hedgeTimer->setSingleShot(true);
+            connect(hedgeTimer, &QTimer::timeout, this, [this, reply]() {
+                sendHedge(reply);
+            });
+            hedgeTimer->start(getHedgeDelay());
+        }
+
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Request '" + pending.key + "' sent, "
+            + QString::number(mActiveRequests.size()) + " active, " + QString::number(mQueue.size()) + " queued."));
+    }
+}
+
+// Sends a single request with its deadline. The latency is measured from the
+// first time the request was sent, i.e. hedged copies keep the send time of
+// the original request.
+QNetworkReply *RequestManager::send(PendingRequest &pending) {
+    pending.request.setRawHeader("Accept-Encoding", ReplyDecoder::acceptEncoding());
+    if(!pending.sent.isValid()) {
+        pending.sent.start();
+    }
+
+    QNetworkReply *reply = mNetworkManager->get(pending.request);
+    new ReplyDecoder(reply);
+    mActiveRequests.insert(reply, pending);
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    emit started(pending.key, reply);
+
+    // The timer is a child of the reply and goes away with it. Aborting
+    // finishes the reply with OperationCanceledError, which is retried.
+    if(mTimeout > 0) {
+        QTimer *deadline = new QTimer(reply);
+        deadline->setSingleShot(true);
+        connect(deadline, SIGNAL(timeout()), reply, SLOT(abort()));
+        deadline->start(mTimeout);
+    }
+
+    return reply;
+}
+
+// Sends an identical request if the original one is still in flight. Hedged
+// copies count against the concurrency limit; if it's reached, the original
+// request has to do.
+void RequestManager::sendHedge(QNetworkReply *reply) {
+    if(!mActiveRequests.contains(reply) || getReplies(mActiveRequests[reply].key).size() > 1) {
+        return;
+    }
+    if(mActiveRequests.size() >= mMaxConcurrentRequests) {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": No reply for '" + mActiveRequests[reply].key + "' yet, but too many requests active to hedge."));
+        return;
+    }
+
+    PendingRequest hedge = mActiveRequests[reply];
+    send(hedge);
+
+    Logger& logger = Logger::getInstance();
+    logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": No reply for '" + hedge.key + "' yet, hedged request sent."));
+}
+
+// All the replies in flight for the given key (more than one if hedged)
+QList<QNetworkReply *> RequestManager::getReplies(QString key) const {
+    QList<QNetworkReply *> replies;
+    QHashIterator<QNetworkReply *, PendingRequest> iRequest(mActiveRequests);
+    while(iRequest.hasNext()) {
+        iRequest.next();
+        if(iRequest.value().key == key) {
+            replies.append(iRequest.key());
+        }
+    }
+    return replies;
+}
+
+void RequestManager::recordLatency(qint64 latency) {
+    mLatencies.append(latency);
+    if(mLatencies.size() > 50) {
+        mLatencies.removeFirst();
+    }
+}
+
+// The 95th percentile of the recent latencies
+int RequestManager::getHedgeDelay(void) const {
+    if(mLatencies.size() < 20) {
+        return mDefaultHedgeDelay;
+    }
+    QList<qint64> latencies = mLatencies;
+    std::sort(latencies.begin(), latencies.end());
+    int index = qMin((int) ceil(0.95*latencies.size()) - 1, latencies.size() - 1);
+    return (int) latencies.at(index);
+}
+
+// Routes the reply to whoever is interested in the given key
+void RequestManager::replyFinished(void) {
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if(reply == nullptr || !mActiveRequests.contains(reply)) {
+        return;
+    }
+    updateCircuitState();
+
+    PendingRequest pending = mActiveRequests.take(reply);
+    QList<QNetworkReply *> siblings = getReplies(pending.key);
+    QNetworkReply::NetworkError error = reply->error();
+    if(error == QNetworkReply::NoError) {
+        // First one wins, cancel the other (hedged) copies
+        QListIterator<QNetworkReply *> iSibling(siblings);
+        while(iSibling.hasNext()) {
+            QNetworkReply *sibling = iSibling.next();
+            mActiveRequests.remove(sibling);
+            disconnect(sibling, 0, this, 0);
+            sibling->abort();
+            sibling->deleteLater();
+        }
+
+        recordLatency(pending.sent.elapsed());
+        recordSuccess();
+        mPendingKeys.remove(pending.key);
+        mCompleted[pending.key].start();
+        emit finished(pending.key, reply);
+    } else {
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Request '" + pending.key + "' failed: " + reply->errorString()));
+
+        // Only transient errors say something about the health of the
+        // endpoint; e.g. a 404 for a single game doesn't.
+        bool transient = isTransient(error);
+        if(transient) {
+            recordFailure();
+        }
+        if(!siblings.isEmpty()) {
+            // A hedged copy is still in flight, let that one decide
+        } else if(transient && pending.attempt < mMaxRetries && getCircuitState() == CIRCUIT_CLOSED) {
+            retry(pending);
+        } else {
+            fail(pending, error);
+        }
+    }
+    reply->deleteLater();
+
+    sendNext();
+}
+
+// Sends the request again after the backoff delay
+void RequestManager::retry(PendingRequest pending) {
+    int delay = getRetryDelay(pending.attempt);
+    pending.attempt++;
+    pending.sent.invalidate();
+
+    Logger& logger = Logger::getInstance();
+    logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": Retrying request '" + pending.key + "' in " + QString::number(delay) + " ms (attempt "
+        + QString::number(pending.attempt) + " of " + QString::number(mMaxRetries) + ")."));
+
+    QTimer::singleShot(delay, this, [this, pending]() {
+        updateCircuitState();
+        if(getCircuitState() == CIRCUIT_OPEN) {
+            fail(pending, QNetworkReply::ServiceUnavailableError);
+        } else {
+            mQueue.prepend(pending);
+            sendNext();
+        }
+    });
+}
+
+// Gives up on a request
+void RequestManager::fail(PendingRequest pending, QNetworkReply::NetworkError error) {
+    mPendingKeys.remove(pending.key);
+    emit failed(pending.key, error);
+}
+
+// Exponential backoff with "equal jitter": half of the delay is fixed, the
+// other half random, so that retries of several clients don't synchronize
+int RequestManager::getRetryDelay(int attempt) const {
+    qint64 delay = qMin((qint64) mRetryDelay << qMin(attempt, 16), (qint64) mMaxRetryDelay);
+    return (int) (delay/2 + qrand() % (delay/2 + 1));
+}
+
+void RequestManager::recordSuccess(void) {
+    mConsecutiveFailures = 0;
+    mCurrentCooldown = mCooldown;
+    setCircuitState(CIRCUIT_CLOSED);
+}
+
+void RequestManager::recordFailure(void) {
+    mConsecutiveFailures++;
+    int state = getCircuitState();
+    if(state == CIRCUIT_HALF_OPEN) {
+        // The probe failed, wait longer this time
+        mCurrentCooldown = qMin(2*mCurrentCooldown, 10*mCooldown);
+        setCircuitState(CIRCUIT_OPEN);
+    } else if(state == CIRCUIT_CLOSED && mConsecutiveFailures >= mFailureThreshold) {
+        setCircuitState(CIRCUIT_OPEN);
+    }
+}
+
+void RequestManager::setCircuitState(int state) {
+    if(state == mCircuitState) {
+        return;
+    }
+    mCircuitState = state;
+
+    Logger& logger = Logger::getInstance();
+    if(state == CIRCUIT_OPEN) {
+        mCircuitOpened.start();
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Circuit breaker opened for " + QString::number(mCurrentCooldown) + " ms."));
+
+        // Shed all the queued requests
+        while(!mQueue.isEmpty()) {
+            fail(mQueue.takeFirst(), QNetworkReply::ServiceUnavailableError);
+        }
+    } else {
+        logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": Circuit breaker " + QString(state == CIRCUIT_CLOSED ? "closed." : "half-open.")));
+    }
+    emit circuitStateChanged(state);
+}
+
+// The breaker changes from open to half-open once the cooldown has expired
+void RequestManager::updateCircuitState(void) {
+    if(mCircuitState == CIRCUIT_OPEN && mCircuitOpened.hasExpired(mCurrentCooldown)) {
+        setCircuitState(CIRCUIT_HALF_OPEN);
+    }
+}
+
+int RequestManager::getCircuitState(void) const {
+    return mCircuitState;
+}
+
+// Errors that are worth retrying
+bool RequestManager::isTransient(QNetworkReply::NetworkError error) {
+    bool transient = false;
+    switch(error) {
+        case QNetworkReply::ConnectionRefusedError:
+        case QNetworkReply::RemoteHostClosedError:
+        case QNetworkReply::HostNotFoundError:
+        case QNetworkReply::TimeoutError:
+        case QNetworkReply::OperationCanceledError:
+        case QNetworkReply::TemporaryNetworkFailureError:
+        case QNetworkReply::NetworkSessionFailedError:
+        case QNetworkReply::UnknownNetworkError:
+        case QNetworkReply::ProxyTimeoutError:
+        case QNetworkReply::InternalServerError:
+        case QNetworkReply::ServiceUnavailableError:
+        case QNetworkReply::UnknownServerError:
+            transient = true;
+            break;
+
+        default:
+            transient = false;
+            break;
+    }
+    return transient;
+}
+
+// Number of requests that are either in flight or queued
+int RequestManager::count(void) const {
+    return mActiveRequests.size() + mQueue.size();
+}
+
+void RequestManager::setMaxConcurrentRequests(int maxConcurrentRequests) {
+    mMaxConcurrentRequests = qMax(1, maxConcurrentRequests);
+    sendNext();
+}
+
+int RequestManager::getMaxConcurrentRequests(void) const {
+    return mMaxConcurrentRequests;
+}
+
+void RequestManager::setFreshnessWindow(int msecs) {
+    mFreshnessWindow = qMax(0, msecs);
+}
+
+int RequestManager::getFreshnessWindow(void) const {
+    return mFreshnessWindow;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef REQUESTMANAGER_H
+#define REQUESTMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+
+// Manages the requests to one endpoint. Any number of requests can be
+// submitted; each request is identified by a key (e.g. the game ID) that is
+// handed back together with the reply upon completion. At most
+// getMaxConcurrentRequests() requests are in flight at any time, the remaining
+// ones are queued and sent in the order they were submitted.
+//
+// Requests are single-flight: submitting a key that is already queued or in
+// flight doesn't send another request, the pending one serves both. Keys that
+// completed less than getFreshnessWindow() ms ago are not requested again.
+//
+// Requests failing with a transient error are retried with exponential
+// backoff and jitter. Repeated failures open a circuit breaker which rejects
+// all requests until the endpoint has had time to recover; after that, a
+// single probe request decides whether the breaker closes again.
+//
+// Every request has a deadline after which it is aborted (and retried).
+// Latency-critical requests can additionally be hedged: if there is no reply
+// within the 95th percentile of the observed latencies, an identical request
+// is sent and whichever reply arrives first is used.
+class RequestManager : public QObject {
+    Q_OBJECT
+
+    public:
+        enum CIRCUIT_STATE {
+            CIRCUIT_CLOSED = 0,
+            CIRCUIT_OPEN,
+            CIRCUIT_HALF_OPEN
+        };
+
+    private:
+        struct PendingRequest {
+            QString key;
+            QNetworkRequest request;
+            int attempt;
+            bool hedged;
+            QElapsedTimer sent;
+        };
+
+        QNetworkAccessManager *mNetworkManager;
+        int mMaxConcurrentRequests;
+        QList<PendingRequest> mQueue;
+        QHash<QNetworkReply *, PendingRequest> mActiveRequests;
+        QSet<QString> mPendingKeys;
+
+        // Time since the last successful completion per key
+        int mFreshnessWindow;
+        QHash<QString, QElapsedTimer> mCompleted;
+
+        // Retries and circuit breaker
+        int mMaxRetries;
+        int mRetryDelay;
+        int mMaxRetryDelay;
+        int mFailureThreshold;
+        int mCooldown;
+        int mCurrentCooldown;
+        int mConsecutiveFailures;
+        int mCircuitState;
+        QElapsedTimer mCircuitOpened;
+
+        // Deadlines and hedging; the latencies of the last successful
+        // requests (in ms) are kept to estimate the 95th percentile
+        int mTimeout;
+        int mDefaultHedgeDelay;
+        QList<qint64> mLatencies;
+
+        void sendNext(void);
+        QNetworkReply *send(PendingRequest &pending);
+        void sendHedge(QNetworkReply *reply);
+        QList<QNetworkReply *> getReplies(QString key) const;
+        void recordLatency(qint64 latency);
+        int getHedgeDelay(void) const;
+        void retry(PendingRequest pending);
+        void fail(PendingRequest pending, QNetworkReply::NetworkError error);
+        void recordSuccess(void);
+        void recordFailure(void);
+        void setCircuitState(int state);
+        void updateCircuitState(void);
+        int getRetryDelay(int attempt) const;
+
+    public:
+        explicit RequestManager(QNetworkAccessManager *networkManager, int maxConcurrentRequests = 4, QObject *parent = 0);
+
+        // Returns false if the request was coalesced with a pending one, if
+        // the last response for the key is still fresh, or if the circuit
+        // breaker is open
+        bool get(QString key, QNetworkRequest request, bool hedged = false);
+        bool isPending(QString key) const;
+        bool isFresh(QString key) const;
+
+        // Forgets when the key last completed, e.g. if its response couldn't
+        // be used, so that it can be requested again right away
+        void invalidate(QString key);
+        int count(void) const;
+
+        void setFreshnessWindow(int msecs);
+        int getFreshnessWindow(void) const;
+
+        void setMaxConcurrentRequests(int maxConcurrentRequests);
+        int getMaxConcurrentRequests(void) const;
+
+        int getCircuitState(void) const;
+        static bool isTransient(QNetworkReply::NetworkError error);
+
+    signals:
+        // Emitted for every reply sent (including retries and hedges) before
+        // any data arrives, e.g. to attach a parser to it
+        void started(QString key, QNetworkReply *reply);
+
+        // The reply is deleted after the signal was delivered
+        void finished(QString key, QNetworkReply *reply);
+        void failed(QString key, QNetworkReply::NetworkError error);
+        void circuitStateChanged(int state);
+
+    private slots:
+        void replyFinished(void);
+};
+
+#endif // REQUESTMANAGER_H
@@ -19,6 +19,8 @@
 
 #include <cmath>
 
+#include <QUrlQuery>
+
 #include "sihfdatasource.h"
 
 #include "eventlist.h"
@@ -29,261 +31,573 @@
 
 #include "logger.h"
 #include "league.h"
-
-// TODO: I should only store the base URLs and then add the parameters dynamically. In particular, this would be helpful if the baseurl changes
-const QString SIHFDataSource::SCORES_URL = "http://data.sihf.ch/Statistic/api/cms/table?alias=today&size=today&searchQuery=1,2,8,10,11//1,2,8,81,90&filterQuery=&orderBy=gameLeague&orderByDescending=false&take=20&filterBy=League&skip=0&language=de";
-const QString SIHFDataSource::DETAILS_URL = "http://data.sihf.ch/statistic/api/cms/gameoverview?alias=gameDetail&language=de&searchQuery=";
+#include "replydecoder.h"
+#include "config.h"
+
+// The endpoints relative to the API base URL, which can be changed through the
+// 'apiBaseUrl' setting (e.g. to point to a local replay server). The paging
+// parameters (take, skip) of the scores are added in getSummariesPage().
+const QString SIHFDataSource::BASE_URL = "http://data.sihf.ch";
+const QString SIHFDataSource::SCORES_PATH = "/Statistic/api/cms/table?alias=today&size=today&searchQuery=1,2,8,10,11//1,2,8,81,90&filterQuery=&orderBy=gameLeague&orderByDescending=false&filterBy=League&language=de";
+const QString SIHFDataSource::DETAILS_PATH = "/statistic/api/cms/gameoverview?alias=gameDetail&language=de&searchQuery=";
+
+// The statuses that can't be told by the progress alone, the first matching
+// rule applies. No name or OT indicator matches any.
+// Note to self: For "Ende", we ignore the additional info about the way the
+// game finished (OT/SO).
+// TODO: We should include this nevertheless since the shootout GWG is added to the OT score.
+const SIHFDataSource::StatusRule SIHFDataSource::STATUS_RULES[] = {
+    {100, "Shootout", nullptr, Game::STATUS_SHOOTOUT},
+    {100, "Ende", nullptr, Game::STATUS_FINAL},
+    {100, "Ende*", "OT", Game::STATUS_FINAL_UNOFFICIAL_OVERTIME},
+    {100, "Ende*", "SO", Game::STATUS_FINAL_UNOFFICIAL_SHOOTOUT},
+    {100, "Ende*", nullptr, Game::STATUS_FINAL_UNOFFICIAL},
+    {100, nullptr, nullptr, Game::STATUS_THIRD_BREAK},  // "End of third", seems to happen from time to time.
+    {88, nullptr, nullptr, Game::STATUS_OVERTIME}
+};
+
+// The statuses in regular time, by sixths of the progress
+const Game::GAME_STATUS SIHFDataSource::REGULAR_STATUSES[] = {
+    Game::STATUS_NOT_STARTED,
+    Game::STATUS_FIRST_PERIOD,
+    Game::STATUS_FIRST_BREAK,
+    Game::STATUS_SECOND_PERIOD,
+    Game::STATUS_SECOND_BREAK,
+    Game::STATUS_THIRD_PERIOD,
+    Game::STATUS_THIRD_BREAK
+};
 
 SIHFDataSource::SIHFDataSource(GameList *gamesList, QObject *parent) : DataSource(gamesList, parent) {
     // Create the network access objects
     mNetworkManager = new QNetworkAccessManager(this);
-    mJSONDecoder = new JsonDecoder(this);
+
+    // One request manager per endpoint; the details requests for the
+    // different games are sent in parallel, up to the configured limit.
+    Config& config = Config::getInstance();
+    int maxConcurrentRequests = config.getValue("maxConcurrentRequests", 4).toInt();
+    mSummariesRequests = new RequestManager(mNetworkManager, maxConcurrentRequests, this);
+    mDetailsRequests = new RequestManager(mNetworkManager, maxConcurrentRequests, this);
+
+    // Repeated requests for the same game within a short time (e.g. the timer
+    // firing right after the user opened a game) are served from the last
+    // parsed result
+    mDetailsRequests->setFreshnessWindow(config.getValue("detailsFreshness", 5000).toInt());
+
+    // The responses are decoded on a separate thread while they're being
+    // downloaded; the models are updated once the results are handed back
+    mParsePipeline = new ParsePipeline(this);
+    connect(mParsePipeline, SIGNAL(parsed(JsonDecoder*)), this, SLOT(applyParseResult(JsonDecoder*)));
+    connect(mSummariesRequests, SIGNAL(started(QString, QNetworkReply*)), this, SLOT(attachParser(QString, QNetworkReply*)));
+    connect(mDetailsRequests, SIGNAL(started(QString, QNetworkReply*)), this, SLOT(attachParser(QString, QNetworkReply*)));
+    connect(mSummariesRequests, SIGNAL(finished(QString, QNetworkReply*)), this, SLOT(parseGameSummaries(QString, QNetworkReply*)));
+    connect(mSummariesRequests, SIGNAL(failed(QString, QNetworkReply::NetworkError)), this, SLOT(handleNetworkError(QString, QNetworkReply::NetworkError)));
+    connect(mDetailsRequests, SIGNAL(finished(QString, QNetworkReply*)), this, SLOT(parseGameDetails(QString, QNetworkReply*)));
+    connect(mDetailsRequests, SIGNAL(failed(QString, QNetworkReply::NetworkError)), this, SLOT(handleNetworkError(QString, QNetworkReply::NetworkError)));
+    connect(mSummariesRequests, SIGNAL(circuitStateChanged(int)), this, SLOT(handleCircuitStateChange(int)));
+    connect(mDetailsRequests, SIGNAL(circuitStateChanged(int)), this, SLOT(handleCircuitStateChange(int)));
+    mWireBytes = 0;
+    mDecodedBytes = 0;
+    mSummariesTotalRows = -1;
+    mArenaHighWater = 0;
+    mHedgeRequests = config.getValue("hedgeRequests", true).toBool();
+    mBaseUrl = config.getValue("apiBaseUrl", BASE_URL).toString();
+    if(mBaseUrl.endsWith('/')) {
+        mBaseUrl.chop(1);
+    }
 }
 
 // Update the game summaries
 void SIHFDataSource::getGameSummaries(void) {
+    // There is already an update in progress, it'll serve this one as well
+    if(!mSummariesPages.isEmpty()) {
+        return;
+    }
+
     // Notify that the update is being started
     emit updateStarted();
 
+    // Request all the pages we expect based on the last update at once; if
+    // there are more, they are requested as soon as the first page arrives.
+    int nPages = 1;
+    if(mSummariesTotalRows > 0) {
+        nPages = (mSummariesTotalRows + SUMMARIES_PAGE_SIZE - 1)/SUMMARIES_PAGE_SIZE;
+    }
+    for(int iPage = 0; iPage < nPages; iPage++) {
+        getSummariesPage(iPage);
+    }
+
+    // Log the request
+    Logger& logger = Logger::getInstance();
+    if(mSummariesPages.isEmpty()) {
+        // The requests were rejected (circuit breaker open)
+        logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": Query not sent, server unavailable."));
+        emit updateFinished();
+    } else {
+        logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": Query sent to server (" + QString::number(nPages) + " pages)."));
+    }
+}
+
+// Requests a single page of the summaries
+void SIHFDataSource::getSummariesPage(int page) {
+    if(mSummariesPages.contains(page)) {
+        return;
+    }
+
     // Request URL and headers
+    QUrl url(mBaseUrl + SCORES_PATH);
+    QUrlQuery query(url);
+    query.addQueryItem("take", QString::number(SUMMARIES_PAGE_SIZE));
+    query.addQueryItem("skip", QString::number(page*SUMMARIES_PAGE_SIZE));
+    url.setQuery(query);
+
     QNetworkRequest request;
-    request.setUrl(QUrl(SIHFDataSource::SCORES_URL));
-    request.setRawHeader("Accept-Encoding", "deflate");
+    request.setUrl(url);
     request.setRawHeader("Referer", "http://www.sihf.ch/de/game-center/");
+    mValidatorCache.addValidators(request);
+
+    // Send the request; the reply is routed to parseGameSummaries() with the
+    // page number as the key
+    SummariesPage summariesPage;
+    summariesPage.received = false;
+    mSummariesPages.insert(page, summariesPage);
+    if(!mSummariesRequests->get(QString::number(page), request)) {
+        mSummariesPages.remove(page);
+    }
+}
 
-    // Send the request and connect the finished() signal of the reply to parser
-    mSummariesReply = mNetworkManager->get(request);
-    connect(mSummariesReply, SIGNAL(finished()), this, SLOT(parseGameSummaries()));
-    connect(mSummariesReply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(handleNetworkError(QNetworkReply::NetworkError)));
+// Attaches a JSON decoder to a reply that has just been sent so that the
+// response is parsed chunk by chunk on the parser thread while it is being
+// downloaded.
+void SIHFDataSource::attachParser(QString key, QNetworkReply *reply) {
+    ReplyDecoder *decoder = reply->findChild<ReplyDecoder *>();
+    if(decoder != nullptr) {
+        // The complete body is only needed for the debug dumps
+        Logger& logger = Logger::getInstance();
+        decoder->setBuffering(logger.getLevel() >= Logger::DEBUG);
+
+        JsonDecoder *json;
+        if(sender() == mSummariesRequests) {
+            json = new SummariesDecoder();
+        } else if(!mIdleDetailsDecoders.isEmpty()) {
+            json = mIdleDetailsDecoders.takeLast();
+            json->setParent(nullptr);
+        } else {
+            json = new DetailsDecoder();
+        }
+        json->setRequest(key, reply->request().url());
+        mParsePipeline->attach(decoder, json);
+    }
+}
+
+// Reads the data that is still pending and updates the transfer statistics.
+// Returns NULL if there's no decoder for the reply.
+ReplyDecoder *SIHFDataSource::readReply(QNetworkReply *reply) {
+    ReplyDecoder *decoder = reply->findChild<ReplyDecoder *>();
+    if(decoder == nullptr) {
+        return nullptr;
+    }
+
+    decoder->readAll();
+    mWireBytes += decoder->getWireBytes();
+    mDecodedBytes += decoder->getDecodedBytes();
 
-    // Log the request
     Logger& logger = Logger::getInstance();
-    logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": Query sent to server."));
+    logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Received " + QString::number(decoder->getWireBytes()) + " bytes ("
+        + QString::number(decoder->getDecodedBytes()) + " decoded), " + QString::number(mWireBytes) + " bytes ("
+        + QString::number(mDecodedBytes) + " decoded) in total."));
+
+    return decoder;
 }
 
-// Parse the response from the HTTP Request
-void SIHFDataSource::parseGameSummaries(void) {
-    // Get the raw data
-    QByteArray rawdata = mSummariesReply->readAll();
+// Handles the response from the HTTP Request. The page is finished decoding
+// on the parser thread and applied in applyGameSummaries(); the pages are
+// collected until all of them have arrived and then parsed in order.
+void SIHFDataSource::parseGameSummaries(QString key, QNetworkReply *reply) {
+    int page = key.toInt();
+    if(!mSummariesPages.contains(page)) {
+        return;
+    }
+    SummariesPage &summariesPage = mSummariesPages[page];
 
-    // Log the raw data for debugging
+    // Read the remaining data
     Logger& logger = Logger::getInstance();
-    QString dumpfile("dump-summaries-" + QDateTime::currentDateTime().toString("yyyy-MM-ddTHHmmss") + ".json");
+    ReplyDecoder *decoder = readReply(reply);
+    if(decoder == nullptr) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No decoder attached to summaries page " + key + "."));
+        summariesPage.received = true;
+        finishGameSummaries();
+        return;
+    }
+
+    // The body couldn't be decoded (e.g. broken compression); make sure the
+    // page is downloaded again in full next time
+    if(decoder->hasError()) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Failed to decode summaries page " + key + ", skipping page."));
+        mValidatorCache.invalidate(reply->request().url());
+        summariesPage.received = true;
+        finishGameSummaries();
+        return;
+    }
+
+    // Nothing to do if this page hasn't changed since the last update. The
+    // body has been tokenized while it was streamed in already; the decoder is
+    // discarded without being finished, so only the model updates are saved.
+    if(!mValidatorCache.isModified(reply, decoder->getContentHash())) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Summaries page " + key + " unchanged, skipping page."));
+        summariesPage.received = true;
+        finishGameSummaries();
+        return;
+    }
+
+    // Log the raw data for debugging
+    QString dumpfile("dump-summaries-" + QDateTime::currentDateTime().toString("yyyy-MM-ddTHHmmss") + (page > 0 ? "-" + key : QString()) + ".json");
     logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Dumping response data to " + dumpfile + "."));
-    logger.dump(dumpfile, rawdata);
-
-    // Parse the response
-    QVariantMap parsedRawdata = this->mJSONDecoder->decode(rawdata);
-    if(parsedRawdata.contains("data")) {
-        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Parsing data..."));
-        QVariantList data = parsedRawdata.value("data").toList();
-        QListIterator<QVariant> iter(data);
-        while(iter.hasNext()) {
-            parseGame(iter.next().toList());
+    logger.dump(dumpfile, decoder->readAll());
+
+    // The response has been parsed while it was received
+    if(!mParsePipeline->finish(decoder)) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No parser attached to summaries page " + key + "."));
+        summariesPage.received = true;
+        finishGameSummaries();
+    }
+}
+
+// Applies a decoded summaries page
+void SIHFDataSource::applyGameSummaries(SummariesDecoder *json) {
+    int page = json->getRequestKey().toInt();
+    if(!mSummariesPages.contains(page)) {
+        return;
+    }
+    SummariesPage &summariesPage = mSummariesPages[page];
+    summariesPage.received = true;
+
+    // Don't apply anything from a truncated or malformed document, and make
+    // sure the page is downloaded again in full next time
+    Logger& logger = Logger::getInstance();
+    if(!json->isComplete() || json->hasError()) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Malformed data in summaries page " + json->getRequestKey() + ", skipping page."));
+        mValidatorCache.invalidate(json->getRequestUrl());
+        finishGameSummaries();
+        return;
+    }
+
+    if(json->hasSchemaDrift()) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Something is wrong with the game summary data, maybe a change in the data format?"));
+    } else if(json->hasData()) {
+        summariesPage.rows = json->getRows();
+        if(json->getDroppedRows() > 0) {
+            logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Dropped " + QString::number(json->getDroppedRows()) + " malformed rows of summaries page " + json->getRequestKey() + "."));
+        }
+        if(page == 0 && summariesPage.rows.isEmpty()) {
+            logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": It appears that the supplied data doesn't contain any game info (no games today?)."));
+        }
+
+        // Request the pages we don't know of yet: Either based on the total
+        // count, or, if the server doesn't tell, as long as the pages are full
+        int totalRows = json->getTotalRows();
+        if(totalRows >= 0) {
+            mSummariesTotalRows = totalRows;
+            int nPages = (totalRows + SUMMARIES_PAGE_SIZE - 1)/SUMMARIES_PAGE_SIZE;
+            for(int iPage = 1; iPage < nPages; iPage++) {
+                getSummariesPage(iPage);
+            }
+        } else if(summariesPage.rows.size() >= SUMMARIES_PAGE_SIZE) {
+            mSummariesTotalRows = qMax(mSummariesTotalRows, (page+2)*SUMMARIES_PAGE_SIZE);
+            getSummariesPage(page+1);
+        } else {
+            mSummariesTotalRows = page*SUMMARIES_PAGE_SIZE + summariesPage.rows.size();
         }
     } else {
         logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No 'data' field in the response from the server."));
     }
 
+    finishGameSummaries();
+}
+
+// Parses the rows of all the pages in order once the last page arrived
+void SIHFDataSource::finishGameSummaries(void) {
+    QMapIterator<int, SummariesPage> iPage(mSummariesPages);
+    while(iPage.hasNext()) {
+        if(!iPage.next().value().received) {
+            return;
+        }
+    }
+
+    Logger& logger = Logger::getInstance();
+    logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Parsing data..."));
+    // Apply all the games of the response as one batch so that the views
+    // (and the league filter) are only updated once
+    mGamesList->beginUpdate();
+    iPage.toFront();
+    while(iPage.hasNext()) {
+        QListIterator<SummaryRecord> iter(iPage.next().value().rows);
+        while(iter.hasNext()) {
+            parseGame(iter.next());
+        }
+    }
+    mGamesList->endUpdate();
+    mSummariesPages.clear();
+
     emit updateFinished();
 }
 
-// Parse the per-game JSON array from the response and put everything in an
-// associative array with predefined fields for internal data exchange between
-// data sources and data stores.
-void SIHFDataSource::parseGame(const QVariantList &data) {
+// Applies a decoded summaries row to the game it belongs to, creating the game
+// if it's not known yet. Rows that haven't changed since the last update are
+// skipped, and of the others only the columns that changed are applied.
+void SIHFDataSource::parseGame(const SummaryRecord &data) {
     Logger& logger = Logger::getInstance();
 
-    // Check lenght of game summary data. Swiss league data may be one entry shorter; broadcast field may be missing
-    if(data.size() == SIHFDataSource::GS_LENGTH || data.size() == SIHFDataSource::GS_LENGTH-1) {
-        // Get game ID
-        QVariantMap details = data[SIHFDataSource::GS_DETAILS].toMap();
-        QString gameId = details.value("gameId").toString();
-        Game *game = mGamesList->getGame(gameId);
+    // Get game ID
+    QString gameId = data.gameId;
+    Game *game = mGamesList->getGame(gameId);
 
-        if(game == NULL) {
-            // Create a new game
-            game = new Game(gameId, mGamesList);
+    quint32 changed = ~0u;
+    QHash<QString, SummaryRecord>::const_iterator previous = mSummaryRows.constFind(gameId);
+    if(game != NULL && previous != mSummaryRows.constEnd()) {
+        changed = SummariesDecoder::getChangedColumns(*previous, data);
+        if(changed == 0) {
+            return;
+        }
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Game " + gameId + " changed (columns 0x" + QString::number(changed, 16) + ")."));
+    }
+    mSummaryRows.insert(gameId, data);
 
-            // Set game info; this is static info, so we only do it the first time
-            QString league = data[SIHFDataSource::GS_LEAGUE_NAME].toString();
-            QString time = data[SIHFDataSource::GS_TIME].toString();
-            QVariantMap hometeam = data[SIHFDataSource::GS_HOMETEAM].toMap();
-            QVariantMap awayteam = data[SIHFDataSource::GS_AWAYTEAM].toMap();
+    if(game == NULL) {
+        // Create a new game
+        game = new Game(gameId, mGamesList);
 
-            // Add the basic game info
-            game->setLeague(SIHFDataSource::getLeagueId(league));
-            game->setDateTime(time);  // TODO: Convert to QDateTime in UTC
+        // Set game info; this is static info, so we only do it the first time
+        game->setLeague(SIHFDataSource::getLeagueId(data.league));
+        game->setDateTime(data.time);  // TODO: Convert to QDateTime in UTC
 
-            // Add the team info
-            // TODO: This should make use of the new classe "Team" to be created
-            game->setHometeam(hometeam.value("id").toString(), hometeam.value("name").toString());
-            game->setAwayteam(awayteam.value("id").toString(), awayteam.value("name").toString());
+        // Add the team info
+        // TODO: This should make use of the new classe "Team" to be created
+        game->setHometeam(data.hometeamId, data.hometeamName);
+        game->setAwayteam(data.awayteamId, data.awayteamName);
 
-            // TODO: Set infos such as place, attendance, refs, etc. (Attendance could actually be set later on as it might change)
+        // TODO: Set infos such as place, attendance, refs, etc. (Attendance could actually be set later on as it might change)
 
-            // Add the game to the games list
-            mGamesList->addGame(game);
+        // Add the game to the games list
+        mGamesList->addGame(game);
 
-            // Debugging
+        // Debugging
 //            logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Game ID " + data["gameId"] + " not found."));
-        } else {
-            // NOP
-        }
+    } else {
+        // NOP
+    }
 
-        // Get score and progress info
-        QVariantMap totalScore = data[SIHFDataSource::GS_TOTALSCORE].toMap();
-        QVariantMap periodsScore = data[SIHFDataSource::GS_PERIODSSCORE].toMap();
-        QString otIndicator = data[SIHFDataSource::GS_OTINDICATOR].toString();
-        QVariantMap meta = data[SIHFDataSource::GS_META].toMap();
-
-        // Put together the score
-        QVariantList homePeriodsScore = periodsScore.value("homeTeam").toList();
-        QVariantList awayPeriodsScore = periodsScore.value("awayTeam").toList();
-        QMap<QString, QString> score;
-        score["first"] = homePeriodsScore.value(0, "-").toString() + ":" + awayPeriodsScore.value(0, "-").toString();
-        score["second"] = homePeriodsScore.value(1, "-").toString() + ":" + awayPeriodsScore.value(1, "-").toString();
-        score["third"] = homePeriodsScore.value(2, "-").toString() + ":" + awayPeriodsScore.value(2, "-").toString();
-        if(homePeriodsScore.size() == 4) {
-            score.insert("overtime", homePeriodsScore[3].toString() + ":" + awayPeriodsScore[3].toString());
-        }
-        score["total"] = totalScore.value("homeTeam").toString() + ":" + totalScore.value("awayTeam").toString();
-        game->setScore(score);
-
-        // Additional info, progress, etc.
-        // 0 - Not started
-        // 17 - 1. period
-        // 33 - 1. break
-        // 50 - 2. Period
-        // 67 - 2. break
-        // 83 - 3. Period
-        // 88 + "Overtime"
-        // 100 - Finished
-        // 100 + "Shootout"
-        // 100 + "Ende*"
-        // 100 + "Ende"
-        // Roughly corresponds to the following formula: progress/100*6 = "old status code"
-        // TODO: Remove those old status hard-coded status codes and replace them by enum-type statuses.
-        double progress = meta.value("percent").toDouble();
-        int status = 0;
-        if(progress == 100) {
-            QString statustext = meta.value("name").toString();
-            if(!statustext.compare("Shootout")) {
-                status = 8;
-            } else if(!statustext.compare("Ende")) {
-                // Note to self: Here we ignore the additional info about the way the game finished (OT/SO)
-                // TODO: We should include this nevertheless since the shootout GWG is added to the OT score.
-                status = 12;
-            } else if(!statustext.compare("Ende*")) {
-                if(!otIndicator.compare("OT")) {
-                    // Unofficial final result after overtime
-                    status = 10;
-                } else if(!otIndicator.compare("SO")) {
-                    // Unofficial final result after shootout
-                    status = 11;
-                } else {
-                    // Unofficial final result
-                    status = 9;
-                }
-            } else {
-                // "End of third", seems to happen from time to time.
-                status = 6;
-            }
-        } else if(progress == 88) {
-            // Overtime in progress
-            status = 7;
-        } else {
-            // Regular, 1, ..., 6
-            status = round(progress/100*6);
+    // Only update what has changed
+    quint32 scoreColumns = (1u << SummariesDecoder::GS_TOTALSCORE) | (1u << SummariesDecoder::GS_PERIODSSCORE) | (1u << SummariesDecoder::GS_OTINDICATOR);
+    if(changed & scoreColumns) {
+        setGameScore(game, data);
+    }
+
+    quint32 statusColumns = (1u << SummariesDecoder::GS_META) | (1u << SummariesDecoder::GS_OTINDICATOR);
+    if(changed & statusColumns) {
+        setGameStatus(game, data);
+    }
+}
+
+// Sets the score of a game from its summaries row
+void SIHFDataSource::setGameScore(Game *game, const SummaryRecord &data) {
+    const QStringList &homePeriodsScore = data.homePeriodsScore;
+    const QStringList &awayPeriodsScore = data.awayPeriodsScore;
+    GameScore score;
+    for(int period = GameScore::SCORE_FIRST; period <= GameScore::SCORE_OVERTIME; period++) {
+        score.setGoals(period, GameScore::parseGoals(homePeriodsScore.value(period)), GameScore::parseGoals(awayPeriodsScore.value(period)));
+    }
+    score.setGoals(GameScore::SCORE_TOTAL, GameScore::parseGoals(data.homeTotalScore), GameScore::parseGoals(data.awayTotalScore));
+    score.setFlag(GameScore::FLAG_OVERTIME_PLAYED, homePeriodsScore.size() == 4);
+    score.setFlag(GameScore::FLAG_DECIDED_OVERTIME, !data.otIndicator.compare("OT"));
+    score.setFlag(GameScore::FLAG_DECIDED_SHOOTOUT, !data.otIndicator.compare("SO"));
+    game->setScore(score);
+}
+
+// Sets the status of a game from the progress info of its summaries row. The
+// progress is given in percent of the regular time plus a status name, e.g.:
+// 0 - Not started
+// 17 - 1. period
+// 33 - 1. break
+// 50 - 2. Period
+// 67 - 2. break
+// 83 - 3. Period
+// 88 + "Overtime"
+// 100 - Finished
+// 100 + "Shootout"
+// 100 + "Ende*"
+// 100 + "Ende"
+// The special cases are looked up in STATUS_RULES; in regular time, the
+// progress roughly corresponds to the period (and break) in sixths.
+void SIHFDataSource::setGameStatus(Game *game, const SummaryRecord &data) {
+    Game::GAME_STATUS status = decodeStatus(data.progress, data.statusText, data.otIndicator);
+    game->setStatus(status);
+
+    Logger& logger = Logger::getInstance();
+    logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Game status calculated to be " + QString::number(status)));
+}
+
+Game::GAME_STATUS SIHFDataSource::decodeStatus(double progress, const QString &name, const QString &otIndicator) {
+    for(unsigned int rule = 0; rule < sizeof(STATUS_RULES)/sizeof(STATUS_RULES[0]); rule++) {
+        const StatusRule &statusRule = STATUS_RULES[rule];
+        if(progress == statusRule.progress
+            && (statusRule.name == nullptr || name == QLatin1String(statusRule.name))
+            && (statusRule.otIndicator == nullptr || otIndicator == QLatin1String(statusRule.otIndicator))) {
+            return statusRule.status;
         }
-        game->setStatus(status);
-        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Game status calculated to be " + status));
-    } else if(data.size() == 1) {
-        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": It appears that the supplied data doesn't contain any game info (no games today?)."));
-    } else {
-        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Something is wrong with the game summary data, maybe a change in the data format?"));
     }
+
+    // Regular, 1, ..., 6
+    int period = qBound(0, (int) round(progress/100*6), (int) (sizeof(REGULAR_STATUSES)/sizeof(REGULAR_STATUSES[0])) - 1);
+    return REGULAR_STATUSES[period];
 }
 
 // Query the NL servers for the game stats
-void SIHFDataSource::getGameDetails(QString gameId) {
+void SIHFDataSource::getGameDetails(QString gameId, bool latencyCritical) {
     // TODO: Uses the same signal as getGameSummaries(), might consider using its own
     emit updateStarted();
 
     // Request URL and eaders
     QNetworkRequest request;
-    request.setUrl(QUrl(SIHFDataSource::DETAILS_URL + gameId));
-    request.setRawHeader("Accept-Encoding", "deflate");
+    request.setUrl(QUrl(mBaseUrl + DETAILS_PATH + gameId));
     request.setRawHeader("Referer", "http://www.sihf.ch/de/game-center/game/");
     //request.setRawHeader("Host", "data.sihf.ch");
+    mValidatorCache.addValidators(request);
 
-    // Send the request and connect the finished() signal of the reply to parser
-    mDetailsReply = mNetworkManager->get(request);
-    connect(mDetailsReply, SIGNAL(finished()), this, SLOT(parseGameDetails()));
-    connect(mDetailsReply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(handleNetworkError(QNetworkReply::NetworkError)));
+    // Send the request; the reply is routed to parseGameDetails() together
+    // with the game ID, so several games can be updated at the same time.
+    // Latency-critical requests (i.e. the game the user is looking at) are
+    // hedged.
+    mDetailsRequests->get(gameId, request, latencyCritical && mHedgeRequests);
 }
 
-// Parse the response of a getGameDetails() request
-void SIHFDataSource::parseGameDetails(void) {
-    // Get the raw data
-    QByteArray rawdata = mDetailsReply->readAll();
+// Handles the response of a getGameDetails() request; the details are applied
+// in applyGameDetails() once they're decoded
+void SIHFDataSource::parseGameDetails(QString gameId, QNetworkReply *reply) {
+    // Read the remaining data
+    Logger& logger = Logger::getInstance();
+    ReplyDecoder *decoder = readReply(reply);
+    if(decoder == nullptr) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No decoder attached to details reply for game " + gameId + "."));
+        mDetailsRequests->invalidate(gameId);
+        return;
+    }
+
+    // The body couldn't be decoded (e.g. broken compression); make sure the
+    // details are downloaded again in full next time
+    if(decoder->hasError()) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Failed to decode the details of game " + gameId + ", skipping update."));
+        mValidatorCache.invalidate(reply->request().url());
+        mDetailsRequests->invalidate(gameId);
+        return;
+    }
 
-    // The API is inconsitent: Apparently, if a game hasn't started, they
-    // automatically include the callback function so we have to strip that
-    // before we can proceed
-    QByteArray callbackString("externalStatisticsCallback(");
-    if(rawdata.startsWith(callbackString)) {
-        // Remove the callback name and the trailing ");"
-        rawdata.remove(0, callbackString.length());
-        rawdata.chop(2);
+    // Nothing to do if the details haven't changed since the last update (see
+    // parseGameSummaries())
+    if(!mValidatorCache.isModified(reply, decoder->getContentHash())) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Details unchanged, skipping update."));
+        return;
     }
 
     // Log the raw data for debugging
-    Logger& logger = Logger::getInstance();
-    QString dumpfile("dump-details-" + QDateTime::currentDateTime().toString("yyyy-MM-ddTHHmmss") + ".json");
+    QString dumpfile("dump-details-" + QDateTime::currentDateTime().toString("yyyy-MM-ddTHHmmss") + "-" + gameId + ".json");
     logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Dumping details data in " + dumpfile + "."));
-    logger.dump(dumpfile, rawdata);
+    logger.dump(dumpfile, decoder->readAll());
+
+    if(!mParsePipeline->finish(decoder)) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No parser attached to details reply for game " + gameId + "."));
+        mValidatorCache.invalidate(reply->request().url());
+        mDetailsRequests->invalidate(gameId);
+    }
+}
 
-    // Convert from JSON to a map, then parse the game details
-    QVariantMap data = mJSONDecoder->decode(rawdata);
-    QString gameId = data["gameId"].toString();
+// Applies decoded game details. The API is inconsistent: Apparently, if a game
+// hasn't started, they automatically include the callback function. The
+// parser skips it.
+void SIHFDataSource::applyGameDetails(DetailsDecoder *json) {
+    Logger& logger = Logger::getInstance();
+    QString gameId = json->getRequestKey();
+    if(!json->isComplete() || json->hasError()) {
+        // A partial record would remove all the events it doesn't contain
+        // from the view, so nothing is applied
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Malformed details data for game " + gameId + ", skipping update."));
+        mValidatorCache.invalidate(json->getRequestUrl());
+        mDetailsRequests->invalidate(gameId);
+        return;
+    }
+    const DetailsRecord &data = json->getRecord();
+    const ParseArena &arena = json->getArena();
+    logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Decoded game " + gameId + " into " + QString::number(arena.getUsed()) + " bytes ("
+        + QString::number(arena.getBlockCount()) + " blocks, " + QString::number(arena.getReserved()) + " bytes reserved)."));
+    if(arena.getHighWater() > mArenaHighWater) {
+        mArenaHighWater = arena.getHighWater();
+        logger.log(Logger::INFO, QString(Q_FUNC_INFO).append(": New details arena high-water mark: " + QString::number(mArenaHighWater) + " bytes."));
+    }
+    if(!data.gameId.isEmpty() && data.gameId != gameId) {
+        logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Reply for game " + gameId + " contains data for game " + data.gameId + "."));
+    }
     Game *game = mGamesList->getGame(gameId);
     if(game != NULL) {
         // Parse all the players; this is done before parsing the events to ensure
         // that the players can be found when the events are rendered in the UI
-        if(data.contains("players")) {
+        if(data.hasPlayers) {
             parsePlayers(game, data);
         } else {
             logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No player data found!"));
         }
 
-        // Parse events
+        // Parse events; they are merged with the ones already shown so that
+        // only the new and removed events are reported to the view
         EventList *events = game->getEventList();
-        events->clear();
-        if(data.contains("summary")) {
-            QVariantMap summary = data["summary"].toMap();
-            QVariantList periods = summary["periods"].toList();
-            QListIterator<QVariant> iter(periods);
+        if(data.hasSummary) {
+            events->beginUpdate();
+            // The periods are numbered from 1; the shootout follows the last
+            // period (which is the overtime if one was played)
+            quint8 number = 0;
+            QVectorIterator<PeriodRecord *> iter(data.periods);
             while(iter.hasNext()) {
-                QVariantMap period = iter.next().toMap();
-                parseGoals(game, period["goals"].toList());
-                parsePenalties(game, period["fouls"].toList());
-                parseGoalkeepers(game, period["goalkeepers"].toList());
+                const PeriodRecord *period = iter.next();
+                number++;
+                parseGoals(game, number, period->goals);
+                parsePenalties(game, number, period->penalties);
+                parseGoalkeepers(game, number, period->goalkeepers);
             }
-            QVariantMap shootout = summary["shootout"].toMap();
-            parseShootout(game, shootout["shoots"].toList());
-            events->sort();
+            parseShootout(game, number + 1, data.shootout);
+            events->endUpdate();
             logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Number of parsed events: "));// + QString::number(events->size())));
         } else {
             logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": No game events data found!"));
         }
     } else {
+        // Make sure that the details are parsed again once the game is known
         logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Game with ID " + gameId + " not found, skipping update."));
+        mValidatorCache.invalidate(json->getRequestUrl());
+        mDetailsRequests->invalidate(gameId);
     }
 }
 
+// Applies the result of the parser thread and releases the decoder
+void SIHFDataSource::applyParseResult(JsonDecoder *json) {
+    SummariesDecoder *summaries = qobject_cast<SummariesDecoder *>(json);
+    DetailsDecoder *details = qobject_cast<DetailsDecoder *>(json);
+    if(summaries != nullptr) {
+        applyGameSummaries(summaries);
+    } else if(details != nullptr) {
+        applyGameDetails(details);
+
+        // Keep the decoder (and the first block of its arena) for the next
+        // response; it's owned by the data source while it's idle
+        if(mIdleDetailsDecoders.size() < MAX_IDLE_DETAILS_DECODERS) {
+            details->reset();
+            details->setParent(this);
+            mIdleDetailsDecoders.append(details);
+            return;
+        }
+    }
+    json->deleteLater();
+}
+
 // Parse players
-void SIHFDataSource::parsePlayers(Game *game, const QVariantMap &data) {
+void SIHFDataSource::parsePlayers(Game *game, const DetailsRecord &data) {
     Logger& logger = Logger::getInstance();
     logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Parsing player data."));
 
@@ -295,41 +609,37 @@ void SIHFDataSource::parsePlayers(Game *game, const QVariantMap &data) {
     // Parse the lineups first to make sure to not include any players that are
     // not actually playing in the current game.
     // TODO: We have to add some safeguards here as well; the lineups might not be set yet.
-    QVariantMap tmp = data["lineUps"].toMap();
-    parseLineup(hometeamPlayers, game->getHometeamId().toULongLong(), tmp["homeTeam"].toMap());
-    parseLineup(awayteamPlayers, game->getAwayteamId().toULongLong(), tmp["awayTeam"].toMap());
+    parseLineup(hometeamPlayers, game->getHometeamId().toULongLong(), data.hometeamLineup);
+    parseLineup(awayteamPlayers, game->getAwayteamId().toULongLong(), data.awayteamLineup);
 
     // Parse the player names
-    QVariantList playersData = data["players"].toList();
-    QListIterator<QVariant> iterator(playersData);
+    qulonglong hometeamId = game->getHometeamId().toULongLong();
+    QVectorIterator<PlayerRecord *> iterator(data.players);
     Player *player;
     while(iterator.hasNext()) {
-        QVariantMap tmp = iterator.next().toMap();
+        const PlayerRecord &tmp = *iterator.next();
 
         // Get basics
-        qulonglong teamId = tmp.value("teamId").toULongLong();
-        quint32 playerId = tmp.value("id").toUInt();
+        qulonglong teamId = tmp.teamId;
+        quint32 playerId = tmp.playerId;
 
         // Get name
-        QString name = tmp.value("fullName").toString();
+        const QString &name = tmp.fullName;
         int index = name.lastIndexOf(" ");
         QString lastName = name.left(index);
         QString firstName = name.right(name.length()-index-1);//.at(index+1);
 
         // Jersey number
-        quint8 jerseyNumber = tmp.value("jerseyNumber").toUInt();
+        quint8 jerseyNumber = tmp.jerseyNumber;
 
         // Create the player
-        if(teamId == game->getHometeamId().toULongLong()) {
-            player = hometeamPlayers->getPlayer(playerId);
-        } else {
-            player = awayteamPlayers->getPlayer(playerId);
-        }
+        PlayerList *players = (teamId == hometeamId) ? hometeamPlayers : awayteamPlayers;
+        player = players->getPlayer(playerId);
 
         // Update the player name and jersey number
         if(player != nullptr) {
             player->setName(firstName, lastName);
-            player->setJerseyNumber(jerseyNumber);
+            players->setJerseyNumber(player, jerseyNumber);
         }
     }
     logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Found a bunch of players.")); // + QString::number(players->size()) + " players."));
@@ -343,39 +653,31 @@ void SIHFDataSource::parsePlayers(Game *game, const QVariantMap &data) {
     //std::sort(players->begin(), players->end(), Player::lessThan);
 }
 
-// The lineup is quite nested in the JSON data, hence we need to "unfold" it.
-// The actual assignments are done in "parsePosition()" below.
-void SIHFDataSource::parseLineup(PlayerList *players, qulonglong teamId, const QVariantMap &data) {
+// The lineup has been "unfolded" into one list of players per position by the
+// decoder. The actual assignments are done in "parsePosition()" below.
+void SIHFDataSource::parseLineup(PlayerList *players, qulonglong teamId, const LineupRecord &data) {
     // Goalkeepers
-    QVariantList goalkeepers = data["goalkeepers"].toList();
-    parsePosition(players, teamId, goalkeepers, Player::POSITION_GK);
+    parsePosition(players, teamId, data.positions[Player::POSITION_GK], Player::POSITION_GK);
 
     // Defencemen
-    QVariantMap defencemen = data["defenders"].toMap();
-    QVariantList leftDefencemen = defencemen["left"].toList();
-    parsePosition(players, teamId, leftDefencemen, Player::POSITION_LD);
-    QVariantList rightDefencemen = defencemen["right"].toList();
-    parsePosition(players, teamId, rightDefencemen, Player::POSITION_RD);
+    parsePosition(players, teamId, data.positions[Player::POSITION_LD], Player::POSITION_LD);
+    parsePosition(players, teamId, data.positions[Player::POSITION_RD], Player::POSITION_RD);
 
     // Forwards
-    QVariantMap forwards = data["forwarders"].toMap();
-    QVariantList leftWings = forwards["left"].toList();
-    parsePosition(players, teamId, leftWings, Player::POSITION_LW);
-    QVariantList center = forwards["center"].toList();
-    parsePosition(players, teamId, center, Player::POSITION_C);
-    QVariantList rightWings = forwards["right"].toList();
-    parsePosition(players, teamId, rightWings, Player::POSITION_RW);
+    parsePosition(players, teamId, data.positions[Player::POSITION_LW], Player::POSITION_LW);
+    parsePosition(players, teamId, data.positions[Player::POSITION_C], Player::POSITION_C);
+    parsePosition(players, teamId, data.positions[Player::POSITION_RW], Player::POSITION_RW);
 }
 
 // Makes the assignment (position, line number) => player
-void SIHFDataSource::parsePosition(PlayerList *players, qulonglong teamId, const QVariantList &data, const quint8 position) {
+void SIHFDataSource::parsePosition(PlayerList *players, qulonglong teamId, const QVector<quint32> &data, const quint8 position) {
     quint32 playerId = 0;
     Player *player = NULL;
     bool newPlayer = false;
 
     quint8 nLines = data.size();
     for(int iLineNumber = 0; iLineNumber < nLines; iLineNumber++) {
-        playerId = data.at(iLineNumber).toUInt();
+        playerId = data.at(iLineNumber);
         player = players->getPlayer(playerId);
         if(player == nullptr) {
             player = new Player(teamId, playerId, players);
@@ -400,106 +702,98 @@ void SIHFDataSource::parseStats(PlayerList *players, QString const teamName, con
 
 }
 
-// Parses the goals data and returns an unsorted QList<GameEvent>
-void SIHFDataSource::parseGoals(Game *game, QVariantList data) {
+// Parses the goals data and adds the goals to the game's events
+void SIHFDataSource::parseGoals(Game *game, quint8 period, const QVector<GoalRecord *> &data) {
     EventList *events = game->getEventList();
     PlayerList *hometeamPlayers = game->getHometeamRoster();
     PlayerList *awayteamPlayers = game->getAwayteamRoster();
 
-    QListIterator<QVariant> iterator(data);
+    qulonglong hometeamId = game->getHometeamId().toULongLong();
+    QVectorIterator<GoalRecord *> iterator(data);
     while(iterator.hasNext()) {
-        QVariantMap goal = iterator.next().toMap();
-        qulonglong teamId = goal.value("teamId").toLongLong();
-        quint32 scorerId = goal.value("scorerLicenceNr").toUInt();
-        quint32 assist1Id = goal.value("assist1LicenceNr").toUInt();
-        quint32 assist2Id = goal.value("assist2LicenceNr").toUInt();
-
-        Event *event = new Event(Event::GOAL);
-        event->setTime(goal.value("time").toString());
-        event->setTeam(teamId);
-
-        // Parse the goal text to extract the score and play (PP1 / EQ / etc.).
-        // The format is '**EQ,GWG** / **0:1** - <Player Names>'.
-        QString haystack = goal.value("text").toString();
-        QRegExp typeNeedle("(\\w+)");
-        typeNeedle.indexIn(haystack);
-        QString type = typeNeedle.cap(1);
-        QRegExp scoreNeedle("(\\d+:\\d+)");
-        scoreNeedle.indexIn(haystack);
-        QString score = scoreNeedle.cap(1);
-        event->setScore(score, type);
-        if(teamId == game->getHometeamId().toULongLong()) {
-            event->addPlayer(Event::SCORER, hometeamPlayers->getPlayer(scorerId));
-            event->addPlayer(Event::FIRST_ASSIST, hometeamPlayers->getPlayer(assist1Id));
-            event->addPlayer(Event::SECOND_ASSIST, hometeamPlayers->getPlayer(assist2Id));
+        const GoalRecord &goal = *iterator.next();
+        qulonglong teamId = goal.teamId;
+        quint32 scorerId = goal.scorerId;
+        quint32 assist1Id = goal.assist1Id;
+        quint32 assist2Id = goal.assist2Id;
+
+        // The score and play (PP1 / EQ / etc.) are extracted from the goal
+        // text by the decoder
+        Event event(Event::GOAL);
+        event.setTime(goal.time);
+        event.setPeriod(period);
+        event.setTeam(teamId);
+        event.setScore(goal.score, goal.scoreType);
+        if(teamId == hometeamId) {
+            event.addPlayer(Event::SCORER, hometeamPlayers->getPlayer(scorerId));
+            event.addPlayer(Event::FIRST_ASSIST, hometeamPlayers->getPlayer(assist1Id));
+            event.addPlayer(Event::SECOND_ASSIST, hometeamPlayers->getPlayer(assist2Id));
         } else {
-            event->addPlayer(Event::SCORER, awayteamPlayers->getPlayer(scorerId));
-            event->addPlayer(Event::FIRST_ASSIST, awayteamPlayers->getPlayer(assist1Id));
-            event->addPlayer(Event::SECOND_ASSIST, awayteamPlayers->getPlayer(assist2Id));
+            event.addPlayer(Event::SCORER, awayteamPlayers->getPlayer(scorerId));
+            event.addPlayer(Event::FIRST_ASSIST, awayteamPlayers->getPlayer(assist1Id));
+            event.addPlayer(Event::SECOND_ASSIST, awayteamPlayers->getPlayer(assist2Id));
         }
         events->insert(event);
     }
 }
 
-// Parses the penalties data and returns an unsorted QList<GameEvent>
-void SIHFDataSource::parsePenalties(Game *game, QVariantList data) {
+// Parses the penalties data and adds the penalties to the game's events
+void SIHFDataSource::parsePenalties(Game *game, quint8 period, const QVector<PenaltyRecord *> &data) {
     EventList *events = game->getEventList();
     PlayerList *hometeamPlayers = game->getHometeamRoster();
     PlayerList *awayteamPlayers = game->getAwayteamRoster();
 
-    QListIterator<QVariant> iterator(data);
+    qulonglong hometeamId = game->getHometeamId().toULongLong();
+    QVectorIterator<PenaltyRecord *> iterator(data);
     while(iterator.hasNext()) {
-        QVariantMap penalty = iterator.next().toMap();
-        qulonglong teamId = penalty.value("teamId").toLongLong();
-        quint32 playerId = penalty.value("playerLicenceNr").toUInt();
-
-        Event *event = new Event(Event::PENALTY);
-        event->setTime(penalty.value("time").toString());
-        event->setTeam(teamId);
-        if(teamId == game->getHometeamId().toULongLong()) {
-            event->addPlayer(Event::PENALIZED, hometeamPlayers->getPlayer(playerId));
+        const PenaltyRecord &penalty = *iterator.next();
+        qulonglong teamId = penalty.teamId;
+        quint32 playerId = penalty.playerId;
+
+        Event event(Event::PENALTY);
+        event.setTime(penalty.time);
+        event.setPeriod(period);
+        event.setTeam(teamId);
+        if(teamId == hometeamId) {
+            event.addPlayer(Event::PENALIZED, hometeamPlayers->getPlayer(playerId));
         } else {
-            event->addPlayer(Event::PENALIZED, awayteamPlayers->getPlayer(playerId));
+            event.addPlayer(Event::PENALIZED, awayteamPlayers->getPlayer(playerId));
         }
-        event->setPenalty(penalty.value("id").toInt(), penalty.value("minutes").toString() + "'");
+        event.setPenalty(penalty.penaltyId, penalty.minutes + "'");
         events->insert(event);
     }
 }
 
 // Parses the GK events
-void SIHFDataSource::parseGoalkeepers(Game *game, QVariantList data) {
+void SIHFDataSource::parseGoalkeepers(Game *game, quint8 period, const QVector<GoalkeeperRecord *> &data) {
     EventList *events = game->getEventList();
     PlayerList *hometeamPlayers = game->getHometeamRoster();
     PlayerList *awayteamPlayers = game->getAwayteamRoster();
 
-    QListIterator<QVariant> iterator(data);
+    qulonglong hometeamId = game->getHometeamId().toULongLong();
+    QVectorIterator<GoalkeeperRecord *> iterator(data);
     while(iterator.hasNext()) {
-        QVariantMap tmp = iterator.next().toMap();
-        qulonglong teamId = tmp.value("teamId").toLongLong();
-        quint32 playerId = tmp.value("playerLicenceNr").toUInt();
-
-        // Parse the action from the human readable data since it isn't provided in the data
-        // The format is '<Player Name> (ACTION)'. where ACTION is either IN or OUT
-        int type = Event::GOALKEEPER_OUT;
-        QString haystack = tmp.value("text").toString();
-        QRegExp needle("\\(IN\\)");
-        if(needle.indexIn(haystack) != -1) {
-            type = Event::GOALKEEPER_IN;
-        }
-        Event *event = new Event(type);
-        event->setTime(tmp.value("time").toString());
-        event->setTeam(teamId);
-        if(teamId == game->getHometeamId().toULongLong()) {
-            event->addPlayer(Event::GOALKEEPER, hometeamPlayers->getPlayer(playerId));
+        const GoalkeeperRecord &tmp = *iterator.next();
+        qulonglong teamId = tmp.teamId;
+        quint32 playerId = tmp.playerId;
+
+        // The action is parsed from the human readable text by the decoder
+        // since it isn't provided in the data
+        Event event(tmp.entering ? Event::GOALKEEPER_IN : Event::GOALKEEPER_OUT);
+        event.setTime(tmp.time);
+        event.setPeriod(period);
+        event.setTeam(teamId);
+        if(teamId == hometeamId) {
+            event.addPlayer(Event::GOALKEEPER, hometeamPlayers->getPlayer(playerId));
         } else {
-            event->addPlayer(Event::GOALKEEPER, awayteamPlayers->getPlayer(playerId));
+            event.addPlayer(Event::GOALKEEPER, awayteamPlayers->getPlayer(playerId));
         }
         events->insert(event);
     }
 }
 
 // Parse shootout
-void SIHFDataSource::parseShootout(Game *game, QVariantList data) {
+void SIHFDataSource::parseShootout(Game *game, quint8 period, const QVector<ShotRecord *> &data) {
     Logger& logger = Logger::getInstance();
     logger.log(Logger::DEBUG, "SIHFDataSource:parseShootout(): Parsing shootout, " + QString::number(data.size()) + " shots.");
 
@@ -507,11 +801,11 @@ void SIHFDataSource::parseShootout(Game *game, QVariantList data) {
     PlayerList *hometeamPlayers = game->getHometeamRoster();
     PlayerList *awayteamPlayers = game->getAwayteamRoster();
 
-    QListIterator<QVariant> iterator(data);
+    QVectorIterator<ShotRecord *> iterator(data);
     while(iterator.hasNext()) {
-        QVariantMap tmp = iterator.next().toMap();
-        quint32 scorerId = tmp["scorerLicenceNr"].toUInt();
-        quint32 goalkeeperId = tmp["goalkeeperLiceneNr"].toUInt();
+        const ShotRecord &tmp = *iterator.next();
+        quint32 scorerId = tmp.scorerId;
+        quint32 goalkeeperId = tmp.goalkeeperId;
 
         // Determine the team based on whether a player can be found in the
         // hometeam's roster or not.
@@ -524,12 +818,14 @@ void SIHFDataSource::parseShootout(Game *game, QVariantList data) {
             teamId = game->getAwayteamId().toULongLong();
         }
 
-        Event *event = new Event(Event::PENALTY_SHOT);
-        event->setTime("65:00." + tmp["number"].toString());
-        event->setPenaltyShot(tmp["scored"].toBool());
-        event->setTeam(teamId);
-        event->addPlayer(Event::SCORER, scorer);
-        event->addPlayer(Event::GOALKEEPER, goalkeeper);
+        Event event(Event::PENALTY_SHOT);
+        // The shots are ordered by their number at the end of the overtime
+        event.setTime(65*Event::TENTHS_PER_MINUTE, tmp.number);
+        event.setPeriod(period);
+        event.setPenaltyShot(tmp.scored);
+        event.setTeam(teamId);
+        event.addPlayer(Event::SCORER, scorer);
+        event.addPlayer(Event::GOALKEEPER, goalkeeper);
         events->insert(event);
     }
 
@@ -541,14 +837,47 @@ void SIHFDataSource::update(QString id) {
     // Query the website and update
     getGameSummaries();
     if(id != NULL) {
-        getGameDetails(id);
+        getGameDetails(id, true);
+    }
+
+    // Also refresh the details of all the other games that are in progress
+    QListIterator<Game *> iGame(mGamesList->getGames());
+    while(iGame.hasNext()) {
+        Game *game = iGame.next();
+        if(game->isInProgress() && game->getGameId() != id) {
+            getGameDetails(game->getGameId());
+        }
     }
 }
 
+qint64 SIHFDataSource::getWireBytes(void) const {
+    return mWireBytes;
+}
+
+qint64 SIHFDataSource::getDecodedBytes(void) const {
+    return mDecodedBytes;
+}
+
 // Handle possible errors when sending queries over the network
-void SIHFDataSource::handleNetworkError(QNetworkReply::NetworkError error) {
+void SIHFDataSource::handleNetworkError(QString key, QNetworkReply::NetworkError error) {
     Logger& logger = Logger::getInstance();
-    logger.log(Logger::ERROR, "SIHFDataSource::handleNetworkError(): Network error occured.");
+    logger.log(Logger::ERROR, QString(Q_FUNC_INFO).append(": Network error " + QString::number(error) + " occured for request '" + key + "'."));
+    emit updateError("Network error");
+
+    // A missing summaries page doesn't stop the others from being parsed
+    if(sender() == mSummariesRequests && mSummariesPages.contains(key.toInt())) {
+        mSummariesPages[key.toInt()].received = true;
+        finishGameSummaries();
+    }
+}
+
+// Tell the UI when an endpoint is considered unavailable
+void SIHFDataSource::handleCircuitStateChange(int state) {
+    if(state == RequestManager::CIRCUIT_OPEN) {
+        emit updateError("Server unavailable, updates paused");
+    } else if(state == RequestManager::CIRCUIT_CLOSED) {
+        emit updateError(QString());
+    }
 }
 
 void SIHFDataSource::getLeagues(QList<QObject *> *leagueList) {
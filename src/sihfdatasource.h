@@ -21,6 +21,7 @@
 #define SIHFDATASOURCE_H
 
 #include <QString>
+#include <QHash>
 #include <QMap>
 #include <QVariantList>
 #include <QtNetwork/QNetworkAccessManager>
@@ -28,53 +29,88 @@
 
 #include "datasource.h"
 #include "gamelist.h"
-#include "jsondecoder.h"
+#include "detailsdecoder.h"
 #include "league.h"
+#include "parsepipeline.h"
 #include "player.h"
+#include "replydecoder.h"
+#include "requestmanager.h"
+#include "summariesdecoder.h"
+#include "validatorcache.h"
 
 class SIHFDataSource : public DataSource {
     Q_OBJECT
 
     private:
         QNetworkAccessManager *mNetworkManager;
-        QNetworkReply *mSummariesReply;
-        QNetworkReply *mDetailsReply;
-        JsonDecoder *mJSONDecoder;
+        RequestManager *mSummariesRequests;
+        RequestManager *mDetailsRequests;
+        ValidatorCache mValidatorCache;
+        ParsePipeline *mParsePipeline;
+
+        // Transfer statistics: bytes received over the wire vs. decoded bytes
+        qint64 mWireBytes;
+        qint64 mDecodedBytes;
+
+        // Summaries pages of the update in progress, by page number
+        struct SummariesPage {
+            bool received;
+            QList<SummaryRecord> rows;
+        };
+        QMap<int, SummariesPage> mSummariesPages;
+        int mSummariesTotalRows;
+
+        // Largest arena used to decode the details so far, and the details
+        // decoders kept for the next responses so that their arenas are
+        // reused
+        size_t mArenaHighWater;
+        QList<DetailsDecoder *> mIdleDetailsDecoders;
+        static const int MAX_IDLE_DETAILS_DECODERS = 4;
+
+        // The last row applied to each game, by game ID
+        QHash<QString, SummaryRecord> mSummaryRows;
+        bool mHedgeRequests;
+        QString mBaseUrl;
 
         // Private helper functions
-        void parseGame(const QVariantList &data);
+        ReplyDecoder *readReply(QNetworkReply *reply);
+        void getSummariesPage(int page);
+        void finishGameSummaries(void);
+        void applyGameSummaries(SummariesDecoder *json);
+        void applyGameDetails(DetailsDecoder *json);
+        void parseGame(const SummaryRecord &data);
+        void setGameScore(Game *game, const SummaryRecord &data);
+        void setGameStatus(Game *game, const SummaryRecord &data);
 
         // Roster & player stats parsing functions
-        void parsePlayers(Game *game, const QVariantMap &data);
-        void parseLineup(PlayerList *players, qulonglong teamId, const QVariantMap &data);
-        void parsePosition(PlayerList *players, qulonglong teamId, const QVariantList &data, const quint8 position);
+        void parsePlayers(Game *game, const DetailsRecord &data);
+        void parseLineup(PlayerList *players, qulonglong teamId, const LineupRecord &data);
+        void parsePosition(PlayerList *players, qulonglong teamId, const QVector<quint32> &data, const quint8 position);
         void parseStats(PlayerList *players, QString const teamName, const QVariantList &data);
 
         // Event parsing functions
-        void parseGoals(Game *game, QVariantList data);
-        void parsePenalties(Game *game, QVariantList data);
-        void parseGoalkeepers(Game *game, QVariantList data);
-        void parseShootout(Game *game, QVariantList data);
+        void parseGoals(Game *game, quint8 period, const QVector<GoalRecord *> &data);
+        void parsePenalties(Game *game, quint8 period, const QVector<PenaltyRecord *> &data);
+        void parseGoalkeepers(Game *game, quint8 period, const QVector<GoalkeeperRecord *> &data);
+        void parseShootout(Game *game, quint8 period, const QVector<ShotRecord *> &data);
+
+        // Status decoding
+        struct StatusRule {
+            int progress;
+            const char *name;
+            const char *otIndicator;
+            Game::GAME_STATUS status;
+        };
+        static const StatusRule STATUS_RULES[];
+        static const Game::GAME_STATUS REGULAR_STATUSES[];
+        static Game::GAME_STATUS decodeStatus(double progress, const QString &name, const QString &otIndicator);
 
         static QMap<uint, League *> mLeaguesMap;
 
-        static const QString SCORES_URL;
-        static const QString DETAILS_URL;
-
-        enum GAME_SUMMARY_FIELDS {
-            GS_LEAGUE_NAME = 0,
-            GS_TIME,
-            GS_HOMETEAM,
-            GS_AWAYTEAM,
-            GS_PHASE,
-            GS_TOTALSCORE,
-            GS_PERIODSSCORE,
-            GS_OTINDICATOR,
-            GS_META,
-            GS_DETAILS,
-            GS_BROADCASTS,
-            GS_LENGTH
-        };
+        static const QString BASE_URL;
+        static const QString SCORES_PATH;
+        static const QString DETAILS_PATH;
+        static const int SUMMARIES_PAGE_SIZE = 20;
 
         enum PLAYER_STATS_FIELDS {
             PS_JERSEYNUMBER = 0,
@@ -93,7 +129,11 @@ class SIHFDataSource : public DataSource {
         explicit SIHFDataSource(GameList *gamesList, QObject *parent = 0);
         void update(QString id);
         void getGameSummaries(void);
-        void getGameDetails(QString gameId);
+        void getGameDetails(QString gameId, bool latencyCritical = false);
+
+        // Transfer statistics
+        qint64 getWireBytes(void) const;
+        qint64 getDecodedBytes(void) const;
 
         // League stuff
         void getLeagues(QList<QObject *> *leagueList);
@@ -101,9 +141,12 @@ class SIHFDataSource : public DataSource {
         static const QMap<uint, League *> initLeagueList(void);
 
     public slots:
-        void parseGameSummaries();
-        void parseGameDetails();
-        void handleNetworkError(QNetworkReply::NetworkError error);
+        void attachParser(QString key, QNetworkReply *reply);
+        void parseGameSummaries(QString key, QNetworkReply *reply);
+        void parseGameDetails(QString gameId, QNetworkReply *reply);
+        void applyParseResult(JsonDecoder *json);
+        void handleNetworkError(QString key, QNetworkReply::NetworkError error);
+        void handleCircuitStateChange(int state);
 };
 
 #endif // SIHFDATASOURCE_H
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QAtomicInt>
+
+// Lock-free bounded queue for exactly one producer thread and one consumer
+// thread. The producer only writes the tail and the consumer only writes the
+// head; the acquire/release pairs make the items visible to the other side.
+template<class T, int CAPACITY>
+class SpscQueue {
+    private:
+        // One slot is always left empty to tell a full from an empty queue
+        T mItems[CAPACITY + 1];
+        QAtomicInt mHead;
+        QAtomicInt mTail;
+
+    public:
+        SpscQueue() : mHead(0), mTail(0) {
+        }
+
+        // Producer side; returns false if the queue is full
+        bool push(const T &item) {
+            int tail = mTail.load();
+            int next = (tail + 1) % (CAPACITY + 1);
+            if(next == mHead.loadAcquire()) {
+                return false;
+            }
+            mItems[tail] = item;
+            mTail.storeRelease(next);
+            return true;
+        }
+
+        // Consumer side; returns false if the queue is empty
+        bool pop(T &item) {
+            int head = mHead.load();
+            if(head == mTail.loadAcquire()) {
+                return false;
+            }
+            item = mItems[head];
+            mItems[head] = T();
+            mHead.storeRelease((head + 1) % (CAPACITY + 1));
+            return true;
+        }
+};
+
+#endif // SPSCQUEUE_H
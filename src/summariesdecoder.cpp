@@ -0,0 +1,339 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "summariesdecoder.h"
+
+// The schema of a summaries row: Each field is either a plain column, or a key
+// of a column that is an object. Lists are arrays of values under such a key.
+namespace {
+    enum FIELD_TYPE {
+        FIELD_TEXT = 0,
+        FIELD_NUMBER,
+        FIELD_LIST
+    };
+
+    struct SummaryField {
+        int column;
+        const char *key;
+        int type;
+        QString SummaryRecord::*text;
+        double SummaryRecord::*number;
+        QStringList SummaryRecord::*list;
+    };
+
+    constexpr SummaryField textField(int column, const char *key, QString SummaryRecord::*member) {
+        return SummaryField{column, key, FIELD_TEXT, member, nullptr, nullptr};
+    }
+
+    constexpr SummaryField numberField(int column, const char *key, double SummaryRecord::*member) {
+        return SummaryField{column, key, FIELD_NUMBER, nullptr, member, nullptr};
+    }
+
+    constexpr SummaryField listField(int column, const char *key, QStringList SummaryRecord::*member) {
+        return SummaryField{column, key, FIELD_LIST, nullptr, nullptr, member};
+    }
+
+    constexpr SummaryField SUMMARY_SCHEMA[] = {
+        textField(SummariesDecoder::GS_LEAGUE_NAME, nullptr, &SummaryRecord::league),
+        textField(SummariesDecoder::GS_TIME, nullptr, &SummaryRecord::time),
+        textField(SummariesDecoder::GS_HOMETEAM, "id", &SummaryRecord::hometeamId),
+        textField(SummariesDecoder::GS_HOMETEAM, "name", &SummaryRecord::hometeamName),
+        textField(SummariesDecoder::GS_AWAYTEAM, "id", &SummaryRecord::awayteamId),
+        textField(SummariesDecoder::GS_AWAYTEAM, "name", &SummaryRecord::awayteamName),
+        textField(SummariesDecoder::GS_TOTALSCORE, "homeTeam", &SummaryRecord::homeTotalScore),
+        textField(SummariesDecoder::GS_TOTALSCORE, "awayTeam", &SummaryRecord::awayTotalScore),
+        listField(SummariesDecoder::GS_PERIODSSCORE, "homeTeam", &SummaryRecord::homePeriodsScore),
+        listField(SummariesDecoder::GS_PERIODSSCORE, "awayTeam", &SummaryRecord::awayPeriodsScore),
+        textField(SummariesDecoder::GS_OTINDICATOR, nullptr, &SummaryRecord::otIndicator),
+        numberField(SummariesDecoder::GS_META, "percent", &SummaryRecord::progress),
+        textField(SummariesDecoder::GS_META, "name", &SummaryRecord::statusText),
+        textField(SummariesDecoder::GS_DETAILS, "gameId", &SummaryRecord::gameId)
+    };
+
+    constexpr int SCHEMA_SIZE = sizeof(SUMMARY_SCHEMA)/sizeof(SUMMARY_SCHEMA[0]);
+
+    // All the fields have to be present in a row
+    constexpr quint32 ALL_FIELDS = (1u << SCHEMA_SIZE) - 1;
+
+    constexpr bool isValidSchema(int field = 0) {
+        return field == SCHEMA_SIZE || (SUMMARY_SCHEMA[field].column >= 0 && SUMMARY_SCHEMA[field].column < SummariesDecoder::GS_LENGTH && isValidSchema(field + 1));
+    }
+
+    static_assert(SCHEMA_SIZE <= 32, "The fields have to fit into a 32 bit mask");
+    static_assert(isValidSchema(), "Schema fields have to refer to existing columns");
+
+    // The field of the plain columns, by column
+    constexpr int findPlainField(int column, int field = 0) {
+        return (field == SCHEMA_SIZE) ? -1 :
+            ((SUMMARY_SCHEMA[field].column == column && SUMMARY_SCHEMA[field].key == nullptr) ? field : findPlainField(column, field + 1));
+    }
+
+    constexpr int PLAIN_FIELDS[] = {
+        findPlainField(SummariesDecoder::GS_LEAGUE_NAME),
+        findPlainField(SummariesDecoder::GS_TIME),
+        findPlainField(SummariesDecoder::GS_HOMETEAM),
+        findPlainField(SummariesDecoder::GS_AWAYTEAM),
+        findPlainField(SummariesDecoder::GS_PHASE),
+        findPlainField(SummariesDecoder::GS_TOTALSCORE),
+        findPlainField(SummariesDecoder::GS_PERIODSSCORE),
+        findPlainField(SummariesDecoder::GS_OTINDICATOR),
+        findPlainField(SummariesDecoder::GS_META),
+        findPlainField(SummariesDecoder::GS_DETAILS),
+        findPlainField(SummariesDecoder::GS_BROADCASTS)
+    };
+
+    static_assert(sizeof(PLAIN_FIELDS)/sizeof(PLAIN_FIELDS[0]) == SummariesDecoder::GS_LENGTH, "One entry per column");
+
+    // Depth of the values of a field: plain columns are in the row, keys in
+    // the column object, and list elements in an array below the key
+    int getValueDepth(const SummaryField &field) {
+        if(field.key == nullptr) {
+            return 3;
+        }
+        return (field.type == FIELD_LIST) ? 5 : 4;
+    }
+}
+
+// The servers have used different names for the total number of rows; the
+// first one found in this list is used
+const QStringList SummariesDecoder::TOTAL_ROWS_KEYS = QStringList() << "totalRows" << "totalCount" << "total" << "count";
+
+SummariesDecoder::SummariesDecoder(QObject *parent) : JsonDecoder(parent) {
+    clear();
+}
+
+void SummariesDecoder::clear(void) {
+    mRows.clear();
+    mHasData = false;
+    mTotalRows = -1;
+    mTotalRowsKey = -1;
+    for(int column = 0; column < GS_LENGTH; column++) {
+        mBindings[column].clear();
+    }
+    mBoundFields = 0;
+    mSchemaChecked = false;
+    mSchemaDrift = false;
+    mDroppedRows = 0;
+}
+
+bool SummariesDecoder::hasData(void) const {
+    return mHasData;
+}
+
+QList<SummaryRecord> SummariesDecoder::getRows(void) const {
+    return mRows;
+}
+
+int SummariesDecoder::getTotalRows(void) const {
+    return mTotalRows;
+}
+
+bool SummariesDecoder::hasSchemaDrift(void) const {
+    return mSchemaDrift;
+}
+
+int SummariesDecoder::getDroppedRows(void) const {
+    return mDroppedRows;
+}
+
+// Returns the row the current token belongs to, if any. The rows are the
+// arrays in the top-level 'data' array, i.e. data[row][column].
+SummaryRecord *SummariesDecoder::getRow(void) {
+    if(getDepth() < 3 || getKey(0) != "data" || mRows.isEmpty() || mSchemaDrift) {
+        return nullptr;
+    }
+
+    SummaryRecord *row = &mRows.last();
+    if(getDepth() == 3) {
+        row->columns = getIndex(2) + 1;
+    }
+    return row;
+}
+
+// Returns the schema field of the current token inside a row (or -1)
+int SummariesDecoder::getField(void) {
+    int column = getIndex(2);
+    if(column < 0 || column >= GS_LENGTH) {
+        return -1;
+    }
+
+    int field = (getDepth() == 3) ? PLAIN_FIELDS[column] : bindField(column);
+    if(field >= 0) {
+        mBoundFields |= (1u << field);
+    }
+    return field;
+}
+
+// Finds the field for the current key of a column object. The key positions
+// are bound to the fields by name once (normally in the first row); after
+// that, the key only has to be compared to the one bound to its position. It
+// is only looked up in the schema again if the layout of the object changed.
+int SummariesDecoder::bindField(int column) {
+    int position = getIndex(3);
+    const QString &key = getKey(3);
+    QVector<Binding> &bindings = mBindings[column];
+    if(position < 0) {
+        return -1;
+    } else if(position < bindings.size() && bindings.at(position).key == key) {
+        return bindings.at(position).field;
+    }
+
+    Binding binding;
+    binding.field = -1;
+    binding.key = key;
+    for(int field = 0; field < SCHEMA_SIZE; field++) {
+        const SummaryField &schemaField = SUMMARY_SCHEMA[field];
+        if(schemaField.column == column && schemaField.key != nullptr && key == QLatin1String(schemaField.key)) {
+            binding.field = field;
+            break;
+        }
+    }
+
+    Binding unbound;
+    unbound.field = -1;
+    while(bindings.size() <= position) {
+        bindings.append(unbound);
+    }
+    bindings[position] = binding;
+    return binding.field;
+}
+
+quint32 SummariesDecoder::getChangedColumns(const SummaryRecord &previous, const SummaryRecord &current) {
+    quint32 columns = 0;
+    for(int field = 0; field < SCHEMA_SIZE; field++) {
+        const SummaryField &schemaField = SUMMARY_SCHEMA[field];
+        bool changed = false;
+        switch(schemaField.type) {
+            case FIELD_TEXT:
+                changed = (previous.*schemaField.text != current.*schemaField.text);
+                break;
+
+            case FIELD_NUMBER:
+                changed = (previous.*schemaField.number != current.*schemaField.number);
+                break;
+
+            case FIELD_LIST:
+                changed = (previous.*schemaField.list != current.*schemaField.list);
+                break;
+
+            default:
+                break;
+        }
+        if(changed) {
+            columns |= (1u << schemaField.column);
+        }
+    }
+    return columns;
+}
+
+// Checks the first complete row against the schema. Rows with just one column
+// mark days without games and aren't checked.
+void SummariesDecoder::checkSchema(const SummaryRecord &row) {
+    if(row.columns <= 1) {
+        return;
+    }
+
+    // Swiss league data may be one entry shorter; broadcast field may be missing
+    bool columnsOk = (row.columns == GS_LENGTH || row.columns == GS_LENGTH-1);
+    if(!columnsOk || (mBoundFields & ALL_FIELDS) != ALL_FIELDS) {
+        mSchemaDrift = true;
+        mRows.clear();
+    }
+    mSchemaChecked = true;
+}
+
+void SummariesDecoder::beginContainer(bool isObject) {
+    if(getDepth() == 1 && getKey(0) == "data" && !isObject) {
+        mHasData = true;
+    } else if(getDepth() == 2 && getKey(0) == "data" && !isObject) {
+        if(!mSchemaDrift) {
+            SummaryRecord row;
+            row.columns = 0;
+            row.progress = 0;
+            mRows.append(row);
+        }
+    } else if(getDepth() <= 4) {
+        // Column objects and lists count as present even if they are empty
+        if(getRow() != nullptr) {
+            getField();
+        }
+    }
+}
+
+void SummariesDecoder::endContainer(bool isObject) {
+    if(getDepth() != 2 || getKey(0) != "data" || isObject || mRows.isEmpty() || mSchemaDrift) {
+        return;
+    }
+
+    // Drop the marker row of days without games
+    const SummaryRecord &row = mRows.last();
+    if(row.columns <= 1) {
+        mRows.removeLast();
+        return;
+    } else if(!mSchemaChecked) {
+        checkSchema(row);
+        if(mSchemaDrift) {
+            return;
+        }
+    }
+
+    // Drop malformed rows; Swiss league data may be one entry shorter
+    if((row.columns != GS_LENGTH && row.columns != GS_LENGTH-1) || row.gameId.isEmpty()) {
+        mRows.removeLast();
+        mDroppedRows++;
+    }
+}
+
+void SummariesDecoder::value(const QVariant &value) {
+    // Top-level fields
+    if(getDepth() == 1) {
+        int key = TOTAL_ROWS_KEYS.indexOf(getKey(0));
+        bool ok = false;
+        int totalRows = value.toInt(&ok);
+        if(key >= 0 && ok && (mTotalRowsKey < 0 || key < mTotalRowsKey)) {
+            mTotalRows = totalRows;
+            mTotalRowsKey = key;
+        }
+        return;
+    }
+
+    SummaryRecord *row = getRow();
+    int field = (row != nullptr && getDepth() <= 5) ? getField() : -1;
+    if(field < 0 || getValueDepth(SUMMARY_SCHEMA[field]) != getDepth()) {
+        return;
+    }
+
+    const SummaryField &schemaField = SUMMARY_SCHEMA[field];
+    switch(schemaField.type) {
+        case FIELD_TEXT:
+            row->*schemaField.text = value.toString();
+            break;
+
+        case FIELD_NUMBER:
+            row->*schemaField.number = value.toDouble();
+            break;
+
+        case FIELD_LIST:
+            (row->*schemaField.list).append(value.toString());
+            break;
+
+        default:
+            break;
+    }
+}
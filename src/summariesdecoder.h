@@ -0,0 +1,129 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef SUMMARIESDECODER_H
+#define SUMMARIESDECODER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "jsondecoder.h"
+
+// A row of the game summaries table
+struct SummaryRecord {
+    int columns;
+    QString gameId;
+    QString league;
+    QString time;
+    QString hometeamId;
+    QString hometeamName;
+    QString awayteamId;
+    QString awayteamName;
+    QStringList homePeriodsScore;
+    QStringList awayPeriodsScore;
+    QString homeTotalScore;
+    QString awayTotalScore;
+    QString otIndicator;
+    double progress;
+    QString statusText;
+};
+
+// Decodes the summaries table (the 'data' array of rows) and the total number
+// of rows reported by the server straight into SummaryRecords. The fields are
+// described by a compile-time schema (see summariesdecoder.cpp). The layout
+// of the column objects is learned from the first row and validated once per
+// response; the following rows are then decoded by position. Rows with the
+// wrong number of columns or without a game ID are dropped.
+class SummariesDecoder : public JsonDecoder {
+    Q_OBJECT
+
+    public:
+        enum GAME_SUMMARY_FIELDS {
+            GS_LEAGUE_NAME = 0,
+            GS_TIME,
+            GS_HOMETEAM,
+            GS_AWAYTEAM,
+            GS_PHASE,
+            GS_TOTALSCORE,
+            GS_PERIODSSCORE,
+            GS_OTINDICATOR,
+            GS_META,
+            GS_DETAILS,
+            GS_BROADCASTS,
+            GS_LENGTH
+        };
+
+    private:
+        // Schema field bound to a key position in a column object
+        struct Binding {
+            int field;
+            QString key;
+        };
+
+        QList<SummaryRecord> mRows;
+        bool mHasData;
+        int mTotalRows;
+        int mTotalRowsKey;
+
+        // Schema binding and drift detection
+        QVector<Binding> mBindings[GS_LENGTH];
+        quint32 mBoundFields;
+        bool mSchemaChecked;
+        bool mSchemaDrift;
+        int mDroppedRows;
+
+        SummaryRecord *getRow(void);
+        int getField(void);
+        int bindField(int column);
+        void checkSchema(const SummaryRecord &row);
+
+        static const QStringList TOTAL_ROWS_KEYS;
+
+    protected:
+        void beginContainer(bool isObject);
+        void endContainer(bool isObject);
+        void value(const QVariant &value);
+        void clear(void);
+
+    public:
+        explicit SummariesDecoder(QObject *parent = 0);
+
+        bool hasData(void) const;
+        QList<SummaryRecord> getRows(void) const;
+
+        // The total number of rows as reported by the server, or -1 if the
+        // response doesn't say
+        int getTotalRows(void) const;
+
+        // True if the rows don't match the schema (in which case no rows are
+        // returned)
+        bool hasSchemaDrift(void) const;
+
+        // The number of rows that were dropped because they have the wrong
+        // number of columns or no game ID
+        int getDroppedRows(void) const;
+
+        // Returns the columns (as a bit mask of GAME_SUMMARY_FIELDS) whose
+        // decoded fields differ between the two rows
+        static quint32 getChangedColumns(const SummaryRecord &previous, const SummaryRecord &current);
+};
+
+#endif // SUMMARIESDECODER_H
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "updatescheduler.h"
+#include "config.h"
+#include "logger.h"
+
+UpdateScheduler::UpdateScheduler(GameList *gamesList, QObject *parent) : QObject(parent) {
+    mGamesList = gamesList;
+    mEnabled = false;
+
+    // Intervals are configured in seconds
+    Config& config = Config::getInstance();
+    mLiveInterval = config.getValue("liveUpdateInterval", 30).toInt()*1000;
+    mBreakInterval = config.getValue("breakUpdateInterval", 120).toInt()*1000;
+    mIdleInterval = config.getValue("idleUpdateInterval", 30*60).toInt()*1000;
+    mPreGameLead = config.getValue("preGameLead", 2*60).toInt()*1000;
+
+    mTimer = new QTimer(this);
+    mTimer->setTimerType(Qt::PreciseTimer);
+    mTimer->setSingleShot(true);
+    connect(mTimer, SIGNAL(timeout()), this, SIGNAL(updateRequested()));
+}
+
+void UpdateScheduler::start(void) {
+    mEnabled = true;
+    reschedule();
+}
+
+void UpdateScheduler::stop(void) {
+    mEnabled = false;
+    mTimer->stop();
+}
+
+void UpdateScheduler::reschedule(void) {
+    if(mEnabled) {
+        int interval = getNextInterval();
+        mTimer->start(interval);
+
+        Logger& logger = Logger::getInstance();
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Next update in " + QString::number(interval/1000) + " s."));
+    }
+}
+
+// The next update is due when the most urgent game needs it
+int UpdateScheduler::getNextInterval(void) const {
+    QDateTime now = QDateTime::currentDateTime();
+    int interval = mIdleInterval;
+    QListIterator<Game *> iGame(mGamesList->getGames());
+    while(iGame.hasNext()) {
+        int gameInterval = getInterval(iGame.next(), now);
+        if(gameInterval > 0 && gameInterval < interval) {
+            interval = gameInterval;
+        }
+    }
+    return interval;
+}
+
+// Polling interval for a single game; -1 if the game doesn't need any updates
+int UpdateScheduler::getInterval(Game *game, const QDateTime &now) const {
+    int interval = -1;
+    switch(game->getStatus()) {
+        // Not started: wake up shortly before the start
+        case Game::STATUS_NOT_STARTED: {
+                QDateTime startTime = game->getStartDateTime();
+                if(startTime.isValid()) {
+                    qint64 untilStart = now.msecsTo(startTime) - mPreGameLead;
+                    interval = (int) qBound((qint64) mLiveInterval, untilStart, (qint64) mIdleInterval);
+                } else {
+                    interval = mBreakInterval;
+                }
+            }
+            break;
+
+        // Intermissions, and unofficial final results which will eventually
+        // become official
+        case Game::STATUS_FIRST_BREAK:
+        case Game::STATUS_SECOND_BREAK:
+        case Game::STATUS_THIRD_BREAK:
+        case Game::STATUS_FINAL_UNOFFICIAL:
+        case Game::STATUS_FINAL_UNOFFICIAL_OVERTIME:
+        case Game::STATUS_FINAL_UNOFFICIAL_SHOOTOUT:
+            interval = mBreakInterval;
+            break;
+
+        // Final
+        case Game::STATUS_FINAL:
+            interval = -1;
+            break;
+
+        // In play
+        default:
+            interval = mLiveInterval;
+            break;
+    }
+
+    return interval;
+}
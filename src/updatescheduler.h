@@ -0,0 +1,67 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDateTime>
+
+#include "gamelist.h"
+#include "game.h"
+
+// Decides when the next update is due based on the status and the start time
+// of the games in the list: Games in play are polled frequently, games in an
+// intermission (or waiting for the official result) less often, and games that
+// haven't started yet only shortly before the puck drops. Finished games are
+// not polled at all.
+class UpdateScheduler : public QObject {
+    Q_OBJECT
+
+    private:
+        GameList *mGamesList;
+        QTimer *mTimer;
+        bool mEnabled;
+
+        // Polling intervals in ms
+        int mLiveInterval;
+        int mBreakInterval;
+        int mIdleInterval;
+        int mPreGameLead;
+
+        int getInterval(Game *game, const QDateTime &now) const;
+
+    public:
+        explicit UpdateScheduler(GameList *gamesList, QObject *parent = 0);
+
+        void start(void);
+        void stop(void);
+        int getNextInterval(void) const;
+
+    signals:
+        void updateRequested(void);
+
+    public slots:
+        // (Re-)schedules the next update, to be called whenever an update
+        // finished
+        void reschedule(void);
+};
+
+#endif // UPDATESCHEDULER_H
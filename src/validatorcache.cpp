@@ -0,0 +1,73 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "validatorcache.h"
+#include "logger.h"
+
+ValidatorCache::ValidatorCache() {
+}
+
+void ValidatorCache::addValidators(QNetworkRequest &request) const {
+    QHash<QUrl, Validators>::const_iterator entry = mValidators.constFind(request.url());
+    if(entry != mValidators.constEnd()) {
+        if(!entry->eTag.isEmpty()) {
+            request.setRawHeader("If-None-Match", entry->eTag);
+        }
+        if(!entry->lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", entry->lastModified);
+        }
+    }
+}
+
+bool ValidatorCache::isModified(QNetworkReply *reply, const QByteArray &contentHash) {
+    Logger& logger = Logger::getInstance();
+
+    // Don't touch the validators for failed requests, the next one has to be
+    // a full request anyway.
+    if(reply->error() != QNetworkReply::NoError) {
+        return true;
+    }
+
+    // The server confirmed that our copy is still valid
+    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if(statusCode == 304) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Not modified (304)."));
+        return false;
+    }
+
+    // Remember the validators sent by the server, if any
+    QUrl url = reply->request().url();
+    Validators &validators = mValidators[url];
+    validators.eTag = reply->rawHeader("ETag");
+    validators.lastModified = reply->rawHeader("Last-Modified");
+
+    // The server doesn't necessarily honor the validators, hence we also
+    // compare the body to the last one we have seen.
+    if(contentHash == validators.contentHash) {
+        logger.log(Logger::DEBUG, QString(Q_FUNC_INFO).append(": Response body unchanged."));
+        return false;
+    }
+    validators.contentHash = contentHash;
+
+    return true;
+}
+
+void ValidatorCache::invalidate(const QUrl &url) {
+    mValidators.remove(url);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef VALIDATORCACHE_H
+#define VALIDATORCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QUrl>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+
+// Keeps the HTTP validators (ETag and Last-Modified) as well as a hash of the
+// last response body per URL. This allows to send conditional requests and to
+// skip applying responses that haven't changed since the last poll. Note that
+// the hash is only known once the whole body has arrived, so an identical body
+// sent with a 200 has already been tokenized while it was streamed in.
+class ValidatorCache {
+    private:
+        struct Validators {
+            QByteArray eTag;
+            QByteArray lastModified;
+            QByteArray contentHash;
+        };
+
+        QHash<QUrl, Validators> mValidators;
+
+    public:
+        ValidatorCache();
+
+        // Adds the If-None-Match / If-Modified-Since headers to the request
+        void addValidators(QNetworkRequest &request) const;
+
+        // Checks whether the reply carries new data and updates the stored
+        // validators. Returns false for 304 responses and for bodies whose
+        // hash matches the one of the last body received for the same URL.
+        bool isModified(QNetworkReply *reply, const QByteArray &contentHash);
+
+        // Forgets the validators for the given URL, forcing a full download
+        // (and parse) on the next request.
+        void invalidate(const QUrl &url);
+};
+
+#endif // VALIDATORCACHE_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include "responsecorpus.h"
+#include "replayserver.h"
+
+// Replays the responses recorded by the app, see README.md. Usage:
+//
+//   replayserver [--port 8080] [--speed 10] [--start 2017-10-21T194500] <dumps>
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("replayserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Local stand-in for the SIHF API serving recorded responses.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory", "Directory containing the dump-*.json files.");
+    QCommandLineOption portOption(QStringList() << "p" << "port", "Port to listen on.", "port", "8080");
+    QCommandLineOption speedOption(QStringList() << "s" << "speed", "Replay speed factor (1: original timeline).", "factor", "1");
+    QCommandLineOption startOption("start", "Recording time to start the replay at (yyyy-MM-ddTHHmmss).", "time");
+    parser.addOption(portOption);
+    parser.addOption(speedOption);
+    parser.addOption(startOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if(parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    ResponseCorpus corpus;
+    if(corpus.load(parser.positionalArguments().first()) == 0) {
+        err << "No recorded responses found." << endl;
+        return 1;
+    }
+
+    double speed = parser.value(speedOption).toDouble();
+    if(speed <= 0) {
+        err << "Invalid speed factor." << endl;
+        return 1;
+    }
+
+    QDateTime startTime = corpus.getStartTime();
+    if(parser.isSet(startOption)) {
+        startTime = QDateTime::fromString(parser.value(startOption), "yyyy-MM-ddTHHmmss");
+        if(!startTime.isValid()) {
+            err << "Invalid start time." << endl;
+            return 1;
+        }
+    }
+
+    ReplayServer server(corpus, speed);
+    quint16 port = parser.value(portOption).toUShort();
+    if(!server.listen(port)) {
+        err << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    server.start(startTime);
+
+    out << "Replaying " << corpus.size() << " responses recorded from " << corpus.getStartTime().toString(Qt::ISODate)
+        << " to " << corpus.getEndTime().toString(Qt::ISODate) << ", starting at " << startTime.toString(Qt::ISODate)
+        << " at " << speed << "x speed." << endl;
+    out << "Set apiBaseUrl to http://<host>:" << port << " to use it." << endl;
+
+    return app.exec();
+}
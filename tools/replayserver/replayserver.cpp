@@ -0,0 +1,143 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <QCryptographicHash>
+#include <QTextStream>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include "replayserver.h"
+
+ReplayServer::ReplayServer(const ResponseCorpus &corpus, double speed, QObject *parent) : QObject(parent), mCorpus(corpus) {
+    mServer = new QTcpServer(this);
+    mSpeed = speed;
+    connect(mServer, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+}
+
+bool ReplayServer::listen(quint16 port) {
+    return mServer->listen(QHostAddress::Any, port);
+}
+
+void ReplayServer::start(const QDateTime &startTime) {
+    mStartTime = startTime;
+    mClock.start();
+}
+
+QDateTime ReplayServer::getReplayTime(void) const {
+    return mStartTime.addMSecs(qint64(mClock.elapsed()*mSpeed));
+}
+
+void ReplayServer::acceptConnection(void) {
+    while(mServer->hasPendingConnections()) {
+        QTcpSocket *socket = mServer->nextPendingConnection();
+        mRequests.insert(socket, QByteArray());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(removeConnection()));
+    }
+}
+
+// Collects the request header; the requests are GETs without a body
+void ReplayServer::readRequest(void) {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if(socket == nullptr || !mRequests.contains(socket)) {
+        return;
+    }
+
+    QByteArray &request = mRequests[socket];
+    request.append(socket->readAll());
+    int end = request.indexOf("\r\n\r\n");
+    if(end >= 0) {
+        QByteArray header = request.left(end);
+        request.clear();
+        respond(socket, header);
+    }
+}
+
+void ReplayServer::removeConnection(void) {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if(socket != nullptr) {
+        mRequests.remove(socket);
+        socket->deleteLater();
+    }
+}
+
+void ReplayServer::respond(QTcpSocket *socket, const QByteArray &header) {
+    // Request line: GET <target> HTTP/1.1
+    QList<QByteArray> requestLine = header.left(header.indexOf("\r\n")).split(' ');
+    if(requestLine.size() < 2 || requestLine.at(0) != "GET") {
+        sendResponse(socket, 405, "Method Not Allowed", QByteArray());
+        return;
+    }
+
+    QUrl url(QString::fromLatin1(requestLine.at(1)));
+    QUrlQuery query(url);
+    QString path = url.path().toLower();
+    QDateTime time = getReplayTime();
+    QByteArray body;
+    if(path.endsWith("/api/cms/table")) {
+        int take = query.queryItemValue("take").toInt();
+        int skip = query.queryItemValue("skip").toInt();
+        int page = (take > 0) ? skip/take : 0;
+        body = mCorpus.getSummaries(page, time);
+    } else if(path.endsWith("/api/cms/gameoverview")) {
+        body = mCorpus.getDetails(query.queryItemValue("searchQuery"), time);
+    }
+
+    QTextStream(stdout) << time.toString(Qt::ISODate) << " GET " << requestLine.at(1) << (body.isEmpty() ? " (not found)" : "") << endl;
+    if(body.isEmpty()) {
+        sendResponse(socket, 404, "Not Found", QByteArray());
+        return;
+    }
+
+    // Support conditional requests like the real server
+    QByteArray eTag = '"' + QCryptographicHash::hash(body, QCryptographicHash::Md5).toHex() + '"';
+    if(getHeader(header, "If-None-Match") == eTag) {
+        sendResponse(socket, 304, "Not Modified", QByteArray(), eTag);
+    } else {
+        sendResponse(socket, 200, "OK", body, eTag);
+    }
+}
+
+void ReplayServer::sendResponse(QTcpSocket *socket, int statusCode, const QByteArray &statusText, const QByteArray &body, const QByteArray &eTag) {
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(statusCode) + " " + statusText + "\r\n";
+    response.append("Content-Type: application/json; charset=utf-8\r\n");
+    response.append("Content-Length: " + QByteArray::number(body.size()) + "\r\n");
+    if(!eTag.isEmpty()) {
+        response.append("ETag: " + eTag + "\r\n");
+    }
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+// Returns the value of the given header field (case-insensitive)
+QByteArray ReplayServer::getHeader(const QByteArray &header, const QByteArray &name) {
+    QList<QByteArray> lines = header.split('\n');
+    QListIterator<QByteArray> iLine(lines);
+    while(iLine.hasNext()) {
+        QByteArray line = iLine.next();
+        int colon = line.indexOf(':');
+        if(colon > 0 && line.left(colon).trimmed().toLower() == name.toLower()) {
+            return line.mid(colon+1).trimmed();
+        }
+    }
+    return QByteArray();
+}
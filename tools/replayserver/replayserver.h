@@ -0,0 +1,67 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef REPLAYSERVER_H
+#define REPLAYSERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include "responsecorpus.h"
+
+// Minimal HTTP server that answers the summaries and details requests with the
+// recorded responses. The recording is replayed on its original timeline,
+// optionally sped up: At wall-clock time t after start(), the responses that
+// were current at startTime + speed*t are served.
+class ReplayServer : public QObject {
+    Q_OBJECT
+
+    private:
+        QTcpServer *mServer;
+        const ResponseCorpus &mCorpus;
+        double mSpeed;
+        QDateTime mStartTime;
+        QElapsedTimer mClock;
+
+        // Partially received request headers per connection
+        QHash<QTcpSocket *, QByteArray> mRequests;
+
+        void respond(QTcpSocket *socket, const QByteArray &header);
+        void sendResponse(QTcpSocket *socket, int statusCode, const QByteArray &statusText, const QByteArray &body, const QByteArray &eTag = QByteArray());
+        static QByteArray getHeader(const QByteArray &header, const QByteArray &name);
+
+    public:
+        explicit ReplayServer(const ResponseCorpus &corpus, double speed, QObject *parent = 0);
+
+        bool listen(quint16 port);
+        void start(const QDateTime &startTime);
+        QDateTime getReplayTime(void) const;
+
+    private slots:
+        void acceptConnection(void);
+        void readRequest(void);
+        void removeConnection(void);
+};
+
+#endif // REPLAYSERVER_H
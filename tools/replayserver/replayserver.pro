@@ -0,0 +1,17 @@
+# Local stand-in for the SIHF API that replays the responses recorded by the
+# app (the dump-*.json files written at debug log level). This is a
+# development tool and not part of the app package.
+TEMPLATE = app
+TARGET = replayserver
+QT = core network
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+SOURCES += \
+    main.cpp \
+    responsecorpus.cpp \
+    replayserver.cpp
+
+HEADERS += \
+    responsecorpus.h \
+    replayserver.h
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+
+#include "responsecorpus.h"
+
+ResponseCorpus::ResponseCorpus() {
+    mSize = 0;
+}
+
+int ResponseCorpus::load(const QString &path) {
+    // dump-<type>-<timestamp>[-<page or game ID>].json
+    QRegExp pattern("dump-(summaries|details)-(\\d{4}-\\d{2}-\\d{2}T\\d{6})(?:-(\\w+))?\\.json");
+    QDir directory(path);
+    QStringList files = directory.entryList(QStringList("dump-*.json"), QDir::Files, QDir::Name);
+    QStringListIterator iFile(files);
+    while(iFile.hasNext()) {
+        QString filename = iFile.next();
+        if(!pattern.exactMatch(filename)) {
+            continue;
+        }
+
+        QDateTime timestamp = QDateTime::fromString(pattern.cap(2), "yyyy-MM-ddTHHmmss");
+        QFile file(directory.filePath(filename));
+        if(!timestamp.isValid() || !file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        // Each file holds a single response, which may span several lines
+        QByteArray body = file.readAll().trimmed();
+        if(body.isEmpty()) {
+            continue;
+        }
+
+        if(pattern.cap(1) == "summaries") {
+            add(mSummaries[pattern.cap(3).toInt()], timestamp, body);
+        } else {
+            // Older dumps don't have the game ID in the file name
+            QString gameId = pattern.cap(3);
+            if(gameId.isEmpty()) {
+                gameId = findGameId(body);
+            }
+            if(!gameId.isEmpty()) {
+                add(mDetails[gameId], timestamp, body);
+            }
+        }
+    }
+
+    return mSize;
+}
+
+// Inserts the response in chronological order; responses with the same time
+// stamp are kept in the order they were recorded in
+void ResponseCorpus::add(QList<Response> &responses, const QDateTime &timestamp, const QByteArray &body) {
+    Response response;
+    response.timestamp = timestamp;
+    response.body = body;
+
+    int index = responses.size();
+    while(index > 0 && responses.at(index-1).timestamp > timestamp) {
+        index--;
+    }
+    responses.insert(index, response);
+
+    if(!mStartTime.isValid() || timestamp < mStartTime) {
+        mStartTime = timestamp;
+    }
+    if(!mEndTime.isValid() || timestamp > mEndTime) {
+        mEndTime = timestamp;
+    }
+    mSize++;
+}
+
+QByteArray ResponseCorpus::find(const QList<Response> &responses, const QDateTime &time) {
+    if(responses.isEmpty()) {
+        return QByteArray();
+    }
+
+    for(int index = responses.size()-1; index >= 0; index--) {
+        if(responses.at(index).timestamp <= time) {
+            return responses.at(index).body;
+        }
+    }
+    return responses.first().body;
+}
+
+QString ResponseCorpus::findGameId(const QByteArray &body) {
+    QRegExp pattern("\"gameId\"\\s*:\\s*\"?(\\d+)");
+    if(pattern.indexIn(QString::fromUtf8(body)) >= 0) {
+        return pattern.cap(1);
+    }
+    return QString();
+}
+
+int ResponseCorpus::size(void) const {
+    return mSize;
+}
+
+QDateTime ResponseCorpus::getStartTime(void) const {
+    return mStartTime;
+}
+
+QDateTime ResponseCorpus::getEndTime(void) const {
+    return mEndTime;
+}
+
+QByteArray ResponseCorpus::getSummaries(int page, const QDateTime &time) const {
+    return find(mSummaries.value(page), time);
+}
+
+QByteArray ResponseCorpus::getDetails(const QString &gameId, const QDateTime &time) const {
+    return find(mDetails.value(gameId), time);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2014-present Roland Hostettler
+ *
+ * This file is part of swisshockey.
+ *
+ * swisshockey is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * swisshockey is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * swisshockey. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef RESPONSECORPUS_H
+#define RESPONSECORPUS_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// The recorded responses, i.e. the dump-summaries-*.json and
+// dump-details-*.json files written by SIHFDataSource. The summaries are kept
+// per page, the details per game; both are sorted by the time they were
+// recorded at.
+class ResponseCorpus {
+    private:
+        struct Response {
+            QDateTime timestamp;
+            QByteArray body;
+        };
+
+        QMap<int, QList<Response> > mSummaries;
+        QHash<QString, QList<Response> > mDetails;
+        QDateTime mStartTime;
+        QDateTime mEndTime;
+        int mSize;
+
+        void add(QList<Response> &responses, const QDateTime &timestamp, const QByteArray &body);
+        static QByteArray find(const QList<Response> &responses, const QDateTime &time);
+        static QString findGameId(const QByteArray &body);
+
+    public:
+        ResponseCorpus();
+
+        // Loads all the dumps in the given directory; returns the number of
+        // responses found
+        int load(const QString &path);
+
+        int size(void) const;
+        QDateTime getStartTime(void) const;
+        QDateTime getEndTime(void) const;
+
+        // The last response recorded at or before the given time (or the
+        // first one if there is none); empty if there is no such response
+        QByteArray getSummaries(int page, const QDateTime &time) const;
+        QByteArray getDetails(const QString &gameId, const QDateTime &time) const;
+};
+
+#endif // RESPONSECORPUS_H